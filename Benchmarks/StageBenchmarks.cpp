@@ -0,0 +1,427 @@
+/*
+  ==============================================================================
+
+    StageBenchmarks.cpp (walrus-bench)
+    Created: 16 Oct 2026
+
+    Per-stage cost of the processor. The processBlock stages (tape delay,
+    reverb, psychedelic post-processing) are isolated through their toggles;
+    the saturation, filter (1-pole and state-variable, also with a swept
+    cutoff), LFO, noise and smoother helpers are measured on their own, the
+    block saturation kernels in both accuracy modes report their max error
+    against the scalar reference, and the tape core is timed with every
+    fractional-delay interpolator, with 1-4 playback heads (also during a
+    delay crossfade) and in every tape storage format.
+
+    Every benchmark reports ns_per_sample and samples_per_second. Write JSON
+    with --benchmark_out=<file> --benchmark_out_format=json (or use the
+    walrus-bench-json target).
+
+  ==============================================================================
+*/
+
+#include <benchmark/benchmark.h>
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+namespace
+{
+    constexpr int toggleTapeDelay = 1;
+    constexpr int toggleReverb = 2;
+    constexpr int togglePsychedelic = 4;
+
+    void fillWithNoise(float* data, int numSamples, juce::Random& random)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+    }
+
+    void setParameter(WalrusDelay1AudioProcessor& processor, const juce::String& id, float value)
+    {
+        auto* parameter = processor.apvts.getParameter(id);
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    // Counters shared by every benchmark: samples are per channel
+    void reportThroughput(benchmark::State& state, int samplesPerIteration)
+    {
+        state.counters["samples_per_second"] = benchmark::Counter(
+            static_cast<double>(samplesPerIteration), benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["ns_per_sample"] = benchmark::Counter(
+            static_cast<double>(samplesPerIteration) * 1.0e-9,
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    }
+
+    //==============================================================================
+    // processBlock with a given toggle combination
+    // args: block size, sample rate, toggle mask
+    void BM_ProcessBlock(benchmark::State& state)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+        const double sampleRate = static_cast<double>(state.range(1));
+        const int toggles = static_cast<int>(state.range(2));
+
+        WalrusDelay1AudioProcessor processor;
+        setParameter(processor, "TapeDelayOnOff", (toggles & toggleTapeDelay) != 0 ? 1.0f : 0.0f);
+        setParameter(processor, "ReverbOnOff", (toggles & toggleReverb) != 0 ? 1.0f : 0.0f);
+        setParameter(processor, "PsychedelicMode", (toggles & togglePsychedelic) != 0 ? 1.0f : 0.0f);
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::Random random(0x5eed);
+        juce::AudioBuffer<float> source(2, blockSize);
+        for (int channel = 0; channel < 2; ++channel)
+            fillWithNoise(source.getWritePointer(channel), blockSize, random);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+
+        // The copy keeps the input level constant; it is a small, fixed part of the cost
+        for (auto _ : state)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                buffer.copyFrom(channel, 0, source, channel, 0, blockSize);
+
+            processor.processBlock(buffer, midi);
+            benchmark::DoNotOptimize(buffer.getReadPointer(0));
+            benchmark::ClobberMemory();
+        }
+
+        reportThroughput(state, blockSize);
+        juce::StringArray stages;
+        if ((toggles & toggleTapeDelay) != 0) stages.add("tape");
+        if ((toggles & toggleReverb) != 0) stages.add("reverb");
+        if ((toggles & togglePsychedelic) != 0) stages.add("psychedelic");
+        state.SetLabel(toggles == 0 ? std::string("bypass") : stages.joinIntoString("+").toStdString());
+    }
+
+    void processBlockArguments(benchmark::internal::Benchmark* benchmark)
+    {
+        benchmark->ArgNames({ "block", "rate", "toggles" });
+
+        for (int toggles = 0; toggles < 8; ++toggles)
+            for (int rate : { 44100, 48000, 96000, 192000 })
+                for (int block : { 16, 64, 256, 1024, 4096 })
+                    benchmark->Args({ block, rate, toggles });
+    }
+
+    BENCHMARK(BM_ProcessBlock)->Apply(processBlockArguments);
+
+    //==============================================================================
+    // Isolated helpers, one block of samples per iteration
+    template <typename Kernel>
+    void runKernel(benchmark::State& state, Kernel&& kernel)
+    {
+        const int blockSize = static_cast<int>(state.range(0));
+
+        juce::Random random(0x5eed);
+        std::vector<float> input(static_cast<size_t>(blockSize));
+        std::vector<float> output(static_cast<size_t>(blockSize));
+        fillWithNoise(input.data(), blockSize, random);
+
+        for (auto _ : state)
+        {
+            kernel(input.data(), output.data(), blockSize);
+            benchmark::DoNotOptimize(output.data());
+            benchmark::ClobberMemory();
+        }
+
+        reportThroughput(state, blockSize);
+    }
+
+    void BM_SoftClip(benchmark::State& state)
+    {
+        runKernel(state, [](const float* in, float* out, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                out[i] = TapeSaturation::softClip(in[i] * 1.2f);
+        });
+    }
+
+    void BM_TubeWarmth(benchmark::State& state)
+    {
+        runKernel(state, [](const float* in, float* out, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                out[i] = TapeSaturation::tubeWarmth(in[i], 0.6f);
+        });
+    }
+
+    // Both tape lanes through the output filter with the cutoff mid-ramp, so
+    // every coefficient update is taken
+    void BM_LaneLowPassFilter(benchmark::State& state)
+    {
+        using Filter = LaneLowPassFilter<2>;
+        const int blockSize = static_cast<int>(state.range(0));
+
+        Filter filter;
+        filter.prepare(48000.0);
+
+        std::vector<Filter::Frame> frames(static_cast<size_t>(blockSize));
+        std::vector<float> cutoff(static_cast<size_t>(blockSize));
+        for (int i = 0; i < blockSize; ++i)
+            cutoff[static_cast<size_t>(i)] = 500.0f + 8000.0f * static_cast<float>(i) / static_cast<float>(blockSize);
+
+        runKernel(state, [&](const float* in, float* out, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                frames[static_cast<size_t>(i)] = { in[i], in[i] };
+
+            filter.process(frames.data(), frames.data(), n, cutoff.data(), 1.0f);
+
+            for (int i = 0; i < n; ++i)
+                out[i] = frames[static_cast<size_t>(i)][0];
+        });
+    }
+
+    // The state-variable filter on both lanes with the same swept cutoff
+    // args: block size, stages (12 / 24 dB/oct)
+    void BM_LaneStateVariableFilter(benchmark::State& state)
+    {
+        using Filter = LaneStateVariableFilter<2>;
+        const int blockSize = static_cast<int>(state.range(0));
+        const int numStages = static_cast<int>(state.range(1));
+
+        Filter filter;
+        filter.prepare(48000.0);
+
+        std::vector<Filter::Frame> frames(static_cast<size_t>(blockSize));
+        std::vector<float> cutoff(static_cast<size_t>(blockSize));
+        for (int i = 0; i < blockSize; ++i)
+            cutoff[static_cast<size_t>(i)] = 500.0f + 8000.0f * static_cast<float>(i) / static_cast<float>(blockSize);
+
+        runKernel(state, [&](const float* in, float* out, int n)
+        {
+            for (int i = 0; i < n; ++i)
+                frames[static_cast<size_t>(i)] = { in[i], in[i] };
+
+            filter.process(frames.data(), frames.data(), n, cutoff.data(), 1.0f, FilterMode::lowPass, 0.5f, numStages);
+
+            for (int i = 0; i < n; ++i)
+                out[i] = frames[static_cast<size_t>(i)][0];
+        });
+    }
+
+    void BM_LFOBank(benchmark::State& state)
+    {
+        LFOBank<1> lfo;
+        lfo.prepare(48000.0);
+        lfo.setFrequency(15.0f);
+
+        runKernel(state, [&lfo](const float*, float* out, int n)
+        {
+            lfo.process(&out, n);
+        });
+    }
+
+    // White noise block fill behind the psychedelic mode tape hiss
+    void BM_XorshiftNoise(benchmark::State& state)
+    {
+        XorshiftNoise noise;
+        noise.seed(0x5eed);
+
+        runKernel(state, [&noise](const float*, float* out, int n)
+        {
+            noise.process(out, n);
+        });
+    }
+
+    // One smoother that is always mid-ramp (the target flips every block)
+    void BM_SmootherBank(benchmark::State& state)
+    {
+        SmootherBank<1> smoothers;
+        smoothers.prepare(static_cast<int>(state.range(0)));
+        smoothers.reset(0, 48000.0, 1.0);
+
+        float target = 1.0f;
+        runKernel(state, [&smoothers, &target](const float*, float* out, int n)
+        {
+            target = 1.0f - target;
+            smoothers.setTargetValue(0, target);
+            std::copy_n(smoothers.process(0, n), n, out);
+        });
+    }
+
+    BENCHMARK(BM_SoftClip)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TubeWarmth)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_LaneLowPassFilter)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_LaneStateVariableFilter)->ArgNames({ "block", "stages" })->ArgsProduct({ { 64, 512, 4096 }, { 1, 2 } });
+    BENCHMARK(BM_LFOBank)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_XorshiftNoise)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_SmootherBank)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+
+    //==============================================================================
+    // Block saturation kernels against the scalar reference. max_abs_error is
+    // measured once over [-20, 20], outside the timed loop.
+    template <typename Kernel, typename Reference>
+    void runSaturationKernel(benchmark::State& state, Kernel&& kernel, Reference&& reference)
+    {
+        std::vector<float> sweep;
+        for (int i = -200000; i <= 200000; ++i)
+            sweep.push_back(static_cast<float>(i) * 1.0e-4f);
+
+        std::vector<float> processed(sweep);
+        kernel(processed.data(), static_cast<int>(processed.size()));
+
+        double maxError = 0.0;
+        for (size_t i = 0; i < sweep.size(); ++i)
+            maxError = juce::jmax(maxError, static_cast<double>(std::abs(processed[i] - reference(sweep[i]))));
+
+        runKernel(state, [&kernel](const float* in, float* out, int n)
+        {
+            std::copy(in, in + n, out);
+            kernel(out, n);
+        });
+
+        state.counters["max_abs_error"] = maxError;
+    }
+
+    template <SaturationAccuracy Accuracy>
+    void BM_SoftClipKernel(benchmark::State& state)
+    {
+        runSaturationKernel(state,
+            [](float* data, int n) { SaturationKernels::softClip<Accuracy>(data, n, 1.2f); },
+            [](float x) { return TapeSaturation::softClip(x * 1.2f); });
+    }
+
+    template <SaturationAccuracy Accuracy>
+    void BM_TubeWarmthKernel(benchmark::State& state)
+    {
+        runSaturationKernel(state,
+            [](float* data, int n) { SaturationKernels::tubeWarmth<Accuracy>(data, n, 0.6f); },
+            [](float x) { return TapeSaturation::tubeWarmth(x, 0.6f); });
+    }
+
+    template <SaturationAccuracy Accuracy>
+    void BM_TanhKernel(benchmark::State& state)
+    {
+        runSaturationKernel(state,
+            [](float* data, int n) { SaturationKernels::tanhCompress<Accuracy>(data, n, 0.8f); },
+            [](float x) { return std::tanh(x * 0.8f) / 0.8f; });
+    }
+
+    BENCHMARK(BM_SoftClipKernel<SaturationAccuracy::exact>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_SoftClipKernel<SaturationAccuracy::fast>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TubeWarmthKernel<SaturationAccuracy::exact>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TubeWarmthKernel<SaturationAccuracy::fast>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TanhKernel<SaturationAccuracy::exact>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TanhKernel<SaturationAccuracy::fast>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+
+    //==============================================================================
+    // Stereo tape core with a slowly swept delay, one block per iteration.
+    // tape_bytes is the memory held by the recorded loop.
+    template <typename Interpolator>
+    void runTapeCore(benchmark::State& state, int blockSize, int numHeads, TapeStorageFormat format, bool crossfade = false)
+    {
+        constexpr double sampleRate = 48000.0;
+
+        TapeDelayLine<2, 4> tapeDelay;
+        tapeDelay.prepare(static_cast<int>(sampleRate), blockSize, format);
+
+        // Head 1 at the delay time, the others evenly spaced before it
+        TapeDelayLine<2, 4>::Heads heads;
+        heads.numHeads = numHeads;
+        for (int head = 0; head < numHeads; ++head)
+        {
+            heads.delayRatio[static_cast<size_t>(head)] = static_cast<float>(numHeads - head) / static_cast<float>(numHeads);
+            heads.feedbackSend[static_cast<size_t>(head)] = head == 0 ? 1.0f : 0.0f;
+        }
+
+        juce::Random random(0x5eed);
+        std::vector<TapeFrame<2>> input(static_cast<size_t>(blockSize)), output(static_cast<size_t>(blockSize));
+        for (auto& frame : input)
+            fillWithNoise(&frame[0], 2, random);
+
+        const std::vector<float> feedback(static_cast<size_t>(blockSize), 0.5f);
+        const std::vector<float> fade(static_cast<size_t>(blockSize), 0.5f);
+        const SoftClipSaturator<SaturationAccuracy::fast> saturate{ 1.2f };
+
+        // The delay ramps linearly over each block; the crossfade form also
+        // reads every head at three quarters of it
+        std::vector<TapeFrame<2>> delays(static_cast<size_t>(blockSize)), fadeDelays(static_cast<size_t>(blockSize));
+        TapeFrame<2> startDelay, endDelay;
+        float phase = 0.0f;
+        for (auto _ : state)
+        {
+            phase += 0.01f;
+            for (int lane = 0; lane < 2; ++lane)
+            {
+                startDelay[lane] = endDelay[lane];
+                endDelay[lane] = 24000.0f + 40.0f * std::sin(phase + static_cast<float>(lane));
+
+                const float slope = (endDelay[lane] - startDelay[lane]) / static_cast<float>(blockSize);
+                for (int sample = 0; sample < blockSize; ++sample)
+                {
+                    delays[static_cast<size_t>(sample)][lane] = startDelay[lane] + slope * static_cast<float>(sample + 1);
+                    fadeDelays[static_cast<size_t>(sample)][lane] = delays[static_cast<size_t>(sample)][lane] * 0.75f;
+                }
+            }
+
+            if (crossfade)
+                tapeDelay.processBlock<Interpolator>(input.data(), output.data(), blockSize, fadeDelays.data(), delays.data(),
+                    fade.data(), feedback.data(), saturate, heads);
+            else
+                tapeDelay.processBlock<Interpolator>(input.data(), output.data(), blockSize,
+                    delays.data(), feedback.data(), saturate, heads);
+            benchmark::DoNotOptimize(output.data());
+            benchmark::ClobberMemory();
+        }
+
+        reportThroughput(state, blockSize);
+        state.counters["tape_bytes"] = static_cast<double>(tapeDelay.getStorageSizeInBytes());
+    }
+
+    // Every fractional-delay interpolator (the Quality parameter)
+    template <typename Interpolator>
+    void BM_TapeInterpolation(benchmark::State& state)
+    {
+        runTapeCore<Interpolator>(state, static_cast<int>(state.range(0)), 1, TapeStorageFormat::float32);
+    }
+
+    BENCHMARK(BM_TapeInterpolation<LinearInterpolation>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TapeInterpolation<HermiteInterpolation>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TapeInterpolation<LagrangeInterpolation>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TapeInterpolation<AllpassInterpolation>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+    BENCHMARK(BM_TapeInterpolation<SincInterpolation>)->ArgName("block")->RangeMultiplier(4)->Range(16, 4096);
+
+    // 1-4 heads reading one loop, 256-sample blocks
+    void BM_TapeHeads(benchmark::State& state)
+    {
+        runTapeCore<LinearInterpolation>(state, 256, static_cast<int>(state.range(0)), TapeStorageFormat::float32);
+    }
+
+    BENCHMARK(BM_TapeHeads)->ArgName("heads")->DenseRange(1, 4);
+
+    // Every TapeStorageFormat, 256-sample blocks
+    void BM_TapeStorage(benchmark::State& state)
+    {
+        runTapeCore<LinearInterpolation>(state, 256, 1, static_cast<TapeStorageFormat>(state.range(0)));
+    }
+
+    BENCHMARK(BM_TapeStorage)->ArgName("format")->DenseRange(0, 2);
+
+    // 1-4 heads during a delay crossfade (tempo sync), 256-sample blocks;
+    // compare with BM_TapeHeads for the cost of the second read pass
+    void BM_TapeCrossfade(benchmark::State& state)
+    {
+        runTapeCore<LinearInterpolation>(state, 256, static_cast<int>(state.range(0)), TapeStorageFormat::float32, true);
+    }
+
+    BENCHMARK(BM_TapeCrossfade)->ArgName("heads")->DenseRange(1, 4);
+}
+
+//==============================================================================
+int main(int argc, char** argv)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    AllocationTripwire.cpp
+    Created: 16 Oct 2026
+
+    Global operator new/delete replacement that reports allocations made while
+    an AllocationTripwire::ScopedArm is alive. Debug builds of the offline
+    tools only - never compile this into the plugin.
+
+  ==============================================================================
+*/
+
+#include "AllocationTripwire.h"
+
+#include <cstdlib>
+#include <new>
+
+#if JUCE_DEBUG
+
+void* operator new(std::size_t size)
+{
+    AllocationTripwire::noteAllocation(size);
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    AllocationTripwire::noteAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#endif
@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    AllocationTripwire.h
+    Created: 16 Oct 2026
+
+    Debug-build check that the audio thread does not touch the heap. While a
+    ScopedArm is alive on a thread, any operator new on that thread counts as
+    a violation and hits a jassert.
+
+    The operator new hook lives in AllocationTripwire.cpp and is only linked
+    into the offline tools: replacing the global allocator inside a plugin
+    binary would also replace it for the host. In the plugin the guard is a
+    no-op.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+struct AllocationTripwire
+{
+    class ScopedArm
+    {
+    public:
+        ScopedArm() noexcept { ++armedDepth; }
+        ~ScopedArm() noexcept { --armedDepth; }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedArm)
+    };
+
+    // Lets a known, intentional allocation through (e.g. a one-off resize)
+    class ScopedDisarm
+    {
+    public:
+        ScopedDisarm() noexcept : savedDepth(armedDepth) { armedDepth = 0; }
+        ~ScopedDisarm() noexcept { armedDepth = savedDepth; }
+
+    private:
+        int savedDepth;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedDisarm)
+    };
+
+    // Called by the operator new hook
+    static void noteAllocation(std::size_t size) noexcept
+    {
+        if (armedDepth == 0)
+            return;
+
+        const ScopedDisarm disarm; // the assertion handler may allocate itself
+        ++violations;
+        juce::ignoreUnused(size);
+        jassertfalse; // heap allocation inside processBlock
+    }
+
+    static int getViolationCount() noexcept { return violations.load(); }
+
+private:
+    static inline thread_local int armedDepth = 0;
+    static inline std::atomic<int> violations{ 0 };
+};
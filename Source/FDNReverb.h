@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    FDNReverb.h
+    Created: 16 Oct 2026
+
+    Per-instance feedback delay network reverb. NumLines delay lines share one
+    power-of-two sized buffer and one write position; every sample the line
+    outputs are damped, mixed through a Householder matrix and fed back.
+
+    All per-line state is kept in contiguous arrays of NumLines floats so the
+    damping, mixing and feedback loops run as packed SIMD operations.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+template <int NumLines>
+class FDNReverb
+{
+public:
+    static_assert(NumLines >= 4 && (NumLines & (NumLines - 1)) == 0, "NumLines must be a power of two");
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        int longestLine = 0;
+        for (int line = 0; line < NumLines; ++line)
+        {
+            auto& length = lineLengths[static_cast<size_t>(line)];
+            length = juce::jmax(1, static_cast<int>(getLineLengthMs(line) * 0.001 * sampleRate));
+            longestLine = juce::jmax(longestLine, length);
+        }
+
+        lineSize = juce::nextPowerOfTwo(longestLine + 1);
+        lineMask = lineSize - 1;
+        buffer.assign(static_cast<size_t>(lineSize * NumLines), 0.0f);
+
+        updateDecay();
+        updateDamping();
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), 0.0f);
+        dampingState.fill(0.0f);
+        writePosition = 0;
+    }
+
+    // Time for the tail to fall by 60 dB
+    void setDecayTime(float newDecaySeconds)
+    {
+        if (newDecaySeconds != decaySeconds)
+        {
+            decaySeconds = newDecaySeconds;
+            updateDecay();
+        }
+    }
+
+    // One-pole low-pass in every line, darkens the tail as it decays
+    void setDampingFrequency(float newFrequency)
+    {
+        if (newFrequency != dampingFrequency)
+        {
+            dampingFrequency = newFrequency;
+            updateDamping();
+        }
+    }
+
+    // Writes the wet signal only; the caller does the dry/wet mix
+    void process(const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        alignas(32) std::array<float, numLines> taps;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            // Read every line
+            for (size_t line = 0; line < numLines; ++line)
+                taps[line] = buffer[line * static_cast<size_t>(lineSize) + static_cast<size_t>((writePosition - lineLengths[line]) & lineMask)];
+
+            // Damping
+            for (size_t line = 0; line < numLines; ++line)
+            {
+                dampingState[line] += dampingCoefficient * (taps[line] - dampingState[line]);
+                taps[line] = dampingState[line];
+            }
+
+            // Even lines feed the left output, odd lines the right
+            float left = 0.0f, right = 0.0f;
+            for (size_t line = 0; line < numLines; line += 2)
+            {
+                left += taps[line];
+                right += taps[line + 1];
+            }
+
+            outputLeft[sample] = left * outputGain;
+            outputRight[sample] = right * outputGain;
+
+            // Householder mix: x - (2 / N) * sum(x)
+            float sum = 0.0f;
+            for (size_t line = 0; line < numLines; ++line)
+                sum += taps[line];
+
+            const float reflection = sum * (2.0f / static_cast<float>(NumLines));
+            const float inL = inputLeft[sample] * inputGain;
+            const float inR = inputRight[sample] * inputGain;
+
+            for (size_t line = 0; line < numLines; ++line)
+            {
+                const float input = (line & 1) == 0 ? inL : inR;
+                buffer[line * static_cast<size_t>(lineSize) + static_cast<size_t>(writePosition)] = (taps[line] - reflection) * lineGains[line] + input;
+            }
+
+            writePosition = (writePosition + 1) & lineMask;
+        }
+    }
+
+private:
+    // Mutually prime-ish lengths between ~30 and ~90 ms, spread over the lines
+    static double getLineLengthMs(int line)
+    {
+        static constexpr double lengths[] = { 29.7, 37.1, 41.1, 43.7, 53.3, 59.9, 67.7, 73.1,
+                                              31.3, 34.9, 47.9, 50.3, 61.7, 71.3, 79.1, 89.3 };
+        return lengths[line % 16] * (1.0 + 0.013 * (line / 16));
+    }
+
+    void updateDecay()
+    {
+        for (size_t line = 0; line < numLines; ++line)
+        {
+            const double lineSeconds = lineLengths[line] / sampleRate;
+            lineGains[line] = static_cast<float>(std::pow(10.0, -3.0 * lineSeconds / juce::jmax(0.05, static_cast<double>(decaySeconds))));
+        }
+    }
+
+    void updateDamping()
+    {
+        const double frequency = juce::jlimit(200.0, sampleRate * 0.45, static_cast<double>(dampingFrequency));
+        dampingCoefficient = static_cast<float>(1.0 - std::exp(-juce::MathConstants<double>::twoPi * frequency / sampleRate));
+    }
+
+    static constexpr size_t numLines = static_cast<size_t>(NumLines);
+    static constexpr float inputGain = 0.5f;
+    static constexpr float outputGain = 2.0f / static_cast<float>(NumLines);
+
+    std::vector<float> buffer;
+    int lineSize = 0;
+    int lineMask = 0;
+    int writePosition = 0;
+
+    alignas(32) std::array<int, numLines> lineLengths{};
+    alignas(32) std::array<float, numLines> lineGains{};
+    alignas(32) std::array<float, numLines> dampingState{};
+
+    double sampleRate = 44100.0;
+    float decaySeconds = 1.8f;
+    float dampingFrequency = 6000.0f;
+    float dampingCoefficient = 0.5f;
+};
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.h
+    Created: 16 Oct 2026
+
+    Per-instance noise for the tape hiss. juce::Random::getSystemRandom() is
+    one generator shared by every instance and thread; these generators
+    belong to one processor, need no locking and are seeded from a fixed
+    value, so an offline render comes out the same every time.
+
+    XorshiftNoise runs several xorshift32 streams side by side and
+    interleaves them, so filling a block is one loop over packed integers.
+    TapeHiss shapes that white noise to pink (Paul Kellet's economy filter)
+    or brown (a leaky integrator) at the same RMS level.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+class XorshiftNoise
+{
+public:
+    static constexpr int numStreams = 8;
+
+    // Every stream gets its own non-zero state from the seed
+    void seed(juce::uint32 seedValue) noexcept
+    {
+        for (int stream = 0; stream < numStreams; ++stream)
+        {
+            // splitmix32-style scramble, so nearby seeds give unrelated streams
+            juce::uint32 x = seedValue + 0x9e3779b9u * static_cast<juce::uint32>(stream + 1);
+            x = (x ^ (x >> 16)) * 0x85ebca6bu;
+            x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+            x ^= x >> 16;
+            state[static_cast<size_t>(stream)] = x != 0 ? x : 0x6d2b79f5u;
+        }
+    }
+
+    // Uniform in [-1, 1)
+    void process(float* dest, int numSamples) noexcept
+    {
+        int start = 0;
+        for (; start + numStreams <= numSamples; start += numStreams)
+            for (int stream = 0; stream < numStreams; ++stream)
+                dest[start + stream] = next(stream);
+
+        for (int stream = 0; start + stream < numSamples; ++stream)
+            dest[start + stream] = next(stream);
+    }
+
+private:
+    inline float next(int stream) noexcept
+    {
+        juce::uint32 x = state[static_cast<size_t>(stream)];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[static_cast<size_t>(stream)] = x;
+
+        return static_cast<float>(static_cast<juce::int32>(x)) * (1.0f / 2147483648.0f);
+    }
+
+    std::array<juce::uint32, numStreams> state{};
+};
+
+//==============================================================================
+// In HissColour parameter order
+enum class HissColour
+{
+    white,
+    pink,
+    brown
+};
+
+template <int NumChannels>
+class TapeHiss
+{
+public:
+    void prepare(int maximumBlockSize)
+    {
+        noise.assign(static_cast<size_t>(maximumBlockSize), 0.0f);
+        reset();
+    }
+
+    // Back to the seeded start, so every render from here is identical
+    void reset() noexcept
+    {
+        for (int channel = 0; channel < NumChannels; ++channel)
+            generators[static_cast<size_t>(channel)].seed(seed + static_cast<juce::uint32>(channel));
+
+        pinkState = {};
+        brownState = {};
+    }
+
+    // Adds hiss to one channel; level is the peak of the white noise, and
+    // pink and brown are scaled to the same RMS
+    void process(int channel, float* data, int numSamples, HissColour colour, float level) noexcept
+    {
+        jassert(numSamples <= static_cast<int>(noise.size()));
+
+        const auto index = static_cast<size_t>(channel);
+        generators[index].process(noise.data(), numSamples);
+
+        if (colour == HissColour::pink)
+        {
+            auto& b = pinkState[index];
+            const float gain = level * pinkGain;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const float white = noise[static_cast<size_t>(sample)];
+                b[0] = 0.99765f * b[0] + white * 0.0990460f;
+                b[1] = 0.96300f * b[1] + white * 0.2965164f;
+                b[2] = 0.57000f * b[2] + white * 1.0526913f;
+                data[sample] += (b[0] + b[1] + b[2] + white * 0.1848f) * gain;
+            }
+        }
+        else if (colour == HissColour::brown)
+        {
+            auto& last = brownState[index];
+            const float gain = level * brownGain;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                last = (last + 0.02f * noise[static_cast<size_t>(sample)]) * (1.0f / 1.02f);
+                data[sample] += last * gain;
+            }
+        }
+        else
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                data[sample] += noise[static_cast<size_t>(sample)] * level;
+        }
+    }
+
+private:
+    static constexpr juce::uint32 seed = 0x7a9e5eedu;
+
+    // RMS of the shaped noise relative to the white noise it is made from
+    static constexpr float pinkGain = 0.337f;
+    static constexpr float brownGain = 10.05f;
+
+    std::array<XorshiftNoise, static_cast<size_t>(NumChannels)> generators;
+    std::array<std::array<float, 3>, static_cast<size_t>(NumChannels)> pinkState{};
+    std::array<float, static_cast<size_t>(NumChannels)> brownState{};
+    std::vector<float> noise;
+};
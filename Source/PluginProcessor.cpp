@@ -38,6 +38,30 @@ WalrusDelay1AudioProcessor::WalrusDelay1AudioProcessor()
     tapeDelayOnOffParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("TapeDelayOnOff"));
     reverbOnOffParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("ReverbOnOff"));
     psychedelicModeParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("PsychedelicMode"));
+    oversamplingParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("Oversampling"));
+    qualityParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("Quality"));
+    headsParam = dynamic_cast<juce::AudioParameterInt*>(apvts.getParameter("Heads"));
+    delaySyncParam = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("DelaySync"));
+    syncDivisionParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("SyncDivision"));
+    syncModifierParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("SyncModifier"));
+    delayModeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("DelayMode"));
+    crossfadeTimeParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("CrossfadeTime"));
+    hissColourParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("HissColour"));
+    filterModeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("FilterMode"));
+    filterResonanceParam = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("FilterResonance"));
+    filterSlopeParam = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter("FilterSlope"));
+
+    for (int head = 0; head < maxTapeHeads; ++head)
+    {
+        const auto prefix = "Head" + juce::String(head + 1);
+        headLevelParams[static_cast<size_t>(head)] = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(prefix + "Level"));
+        headPanParams[static_cast<size_t>(head)] = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(prefix + "Pan"));
+        headFeedbackParams[static_cast<size_t>(head)] = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(prefix + "Feedback"));
+
+        jassert(headLevelParams[static_cast<size_t>(head)] != nullptr);
+        jassert(headPanParams[static_cast<size_t>(head)] != nullptr);
+        jassert(headFeedbackParams[static_cast<size_t>(head)] != nullptr);
+    }
 
     jassert(delayTimeParam != nullptr);
     jassert(feedbackParam != nullptr);
@@ -52,12 +76,32 @@ WalrusDelay1AudioProcessor::WalrusDelay1AudioProcessor()
     jassert(tapeDelayOnOffParam != nullptr);
     jassert(reverbOnOffParam != nullptr);
     jassert(psychedelicModeParam != nullptr);
+    jassert(oversamplingParam != nullptr);
+    jassert(qualityParam != nullptr);
+    jassert(headsParam != nullptr);
+    jassert(delaySyncParam != nullptr);
+    jassert(syncDivisionParam != nullptr);
+    jassert(syncModifierParam != nullptr);
+    jassert(delayModeParam != nullptr);
+    jassert(crossfadeTimeParam != nullptr);
+    jassert(hissColourParam != nullptr);
+    jassert(filterModeParam != nullptr);
+    jassert(filterResonanceParam != nullptr);
+    jassert(filterSlopeParam != nullptr);
+
+    for (int i = 0; i < maxOversamplingLog2; ++i)
+        oversamplers[static_cast<size_t>(i)] = std::make_unique<juce::dsp::Oversampling<float>>(
+            2, static_cast<size_t>(i + 1), juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
 
-    smoothedDelayTime.reset(44100, 0.005);
-    smoothedFeedback.reset(44100, 0.05);
-    smoothedDryWet.reset(44100, 0.005);
-    smoothedReverbLevel.reset(44100, 0.05);
-    smoothedFilterFreq.reset(44100, 0.05);
+    for (auto mode : { RenderMode::realtime, RenderMode::offline })
+        setRenderProfile(mode, getDefaultRenderProfile(mode));
+
+    smoothers.reset(delayTimeSmoother, 44100, 0.005);
+    smoothers.reset(feedbackSmoother, 44100, 0.05);
+    smoothers.reset(dryWetSmoother, 44100, 0.005);
+    smoothers.reset(reverbLevelSmoother, 44100, 0.05);
+    smoothers.reset(filterFreqSmoother, 44100, 0.05);
+    smoothers.reset(tapeLevelSmoother, 44100, 0.01);
 }
 
 WalrusDelay1AudioProcessor::~WalrusDelay1AudioProcessor()
@@ -73,7 +117,44 @@ const juce::String WalrusDelay1AudioProcessor::getName() const
 bool WalrusDelay1AudioProcessor::acceptsMidi() const { return false; }
 bool WalrusDelay1AudioProcessor::producesMidi() const { return false; }
 bool WalrusDelay1AudioProcessor::isMidiEffect() const { return false; }
-double WalrusDelay1AudioProcessor::getTailLengthSeconds() const { return 2.0; }
+
+double WalrusDelay1AudioProcessor::getTailLengthSeconds() const
+{
+    // Upper bound for the output to fall below silenceThreshold after the
+    // input stops: the echoes, then the reverb fed by the last echo
+    double tailSeconds = 0.0;
+    const bool psychedelic = psychedelicModeParam->get();
+
+    if (tapeDelayOnOffParam->get())
+    {
+        // Small-signal loop gain: feedback times the slope of the saturator at
+        // zero times what the heads send back times the loop filter's peak,
+        // capped by the loop-gain limiter. Head 1 has the longest delay, so
+        // timing every echo by it is an upper bound.
+        const double slope = getSaturatorSlope(saturationParam->get(), psychedelic)
+            * LaneStateVariableFilter<numTapeLanes>::getPeakGain(static_cast<FilterMode>(filterModeParam->getIndex()),
+                filterResonanceParam->get(), filterSlopeParam->getIndex() + 1);
+
+        double feedbackSends = 0.0;
+        for (int head = 0; head < headsParam->get(); ++head)
+            feedbackSends += headFeedbackParams[static_cast<size_t>(head)]->get();
+
+        const double loopGain = juce::jmin(feedbackParam->get() * slope * feedbackSends, static_cast<double>(maxLoopGain));
+
+        const double delayMs = delaySyncParam->get() ? tempoSync.getLastDelayMs() : delayTimeParam->get();
+        const double loopSeconds = delayMs * 0.001 * getMaximumModulation(wowDepthParam->get(), flutterDepthParam->get());
+        const double numEchoes = loopGain > 0.0 ? 1.0 + std::floor(std::log(silenceThreshold) / std::log(loopGain)) : 1.0;
+        tailSeconds += loopSeconds * numEchoes;
+    }
+
+    // RT60 scaled to the silence threshold
+    if (reverbOnOffParam->get())
+        tailSeconds += (psychedelic ? psychedelicReverbDecaySeconds : reverbDecaySeconds)
+            * 20.0 * std::log10(silenceThreshold) / -60.0;
+
+    return tailSeconds;
+}
+
 int WalrusDelay1AudioProcessor::getNumPrograms() { return 1; }
 int WalrusDelay1AudioProcessor::getCurrentProgram() { return 0; }
 void WalrusDelay1AudioProcessor::setCurrentProgram(int) {}
@@ -86,50 +167,111 @@ void WalrusDelay1AudioProcessor::prepareToPlay(double sampleRate, int samplesPer
     currentSampleRate = sampleRate;
     currentSamplesPerBlock = samplesPerBlock;
 
-    const int maxDelaySamples = static_cast<int>(sampleRate * 3.0);
+    maxDelaySamples = static_cast<int>(sampleRate * 3.0);
 
-    // Prepare tape delays
-    for (auto& delay : tapeDelays)
-    {
-        delay.prepare(sampleRate, maxDelaySamples);
-    }
+    // The tape loop may run at up to 4x the host rate
+    const int maxTapeBlockSize = samplesPerBlock << maxOversamplingLog2;
 
-    // Prepare LFOs
-    wowLFO.prepare({ sampleRate, static_cast<juce::uint32>(samplesPerBlock), 2 });
-    flutterLFO.prepare({ sampleRate, static_cast<juce::uint32>(samplesPerBlock), 2 });
-    wowLFO.setFrequency(wowRateParam->get());
-    flutterLFO.setFrequency(flutterRateParam->get());
+    for (auto& oversampler : oversamplers)
+        oversampler->initProcessing(static_cast<size_t>(samplesPerBlock));
 
-    // Prepare filters
-    for (auto& filter : feedbackFilters)
-    {
-        filter.prepare(sampleRate);
-        filter.setCutoff(filterFreqParam->get());
-    }
+    // Prepare tape delay
+    tapeDelay.prepare(maxDelaySamples << maxOversamplingLog2, maxTapeBlockSize, tapeStorageFormat);
+
+    sleeping = false;
+    silentSamples = 0;
 
     // Reset smoothing
-    smoothedDelayTime.reset(sampleRate, 0.005);
-    smoothedDelayTime.setCurrentAndTargetValue(delayTimeParam->get());
-    smoothedFeedback.reset(sampleRate, 0.05);
-    smoothedFeedback.setCurrentAndTargetValue(feedbackParam->get());
-    smoothedDryWet.reset(sampleRate, 0.005);
-    smoothedDryWet.setCurrentAndTargetValue(dryWetParam->get());
-    smoothedReverbLevel.reset(sampleRate, 0.05);
-    smoothedReverbLevel.setCurrentAndTargetValue(reverbLevelParam->get());
-    smoothedFilterFreq.reset(sampleRate, 0.05);
-    smoothedFilterFreq.setCurrentAndTargetValue(filterFreqParam->get());
+    smoothers.prepare(maxTapeBlockSize);
+    smoothers.setCurrentAndTargetValue(delayTimeSmoother, delaySyncParam->get() ? tempoSync.getLastDelayMs() : delayTimeParam->get());
+    smoothers.setCurrentAndTargetValue(feedbackSmoother, getLimitedFeedback(captureParameters()));
+    smoothers.setCurrentAndTargetValue(dryWetSmoother, dryWetParam->get());
+    smoothers.reset(reverbLevelSmoother, sampleRate, 0.05);
+    smoothers.setCurrentAndTargetValue(reverbLevelSmoother, reverbLevelParam->get());
+    smoothers.setCurrentAndTargetValue(filterFreqSmoother, filterFreqParam->get());
+    smoothers.setCurrentAndTargetValue(tapeLevelSmoother, 1.0f);
+
+    // Prepare reverb
+    reverb.prepare(sampleRate);
+    tapeHiss.prepare(samplesPerBlock);
+    wobbleLFO.prepare(sampleRate);
+    wobbleLFO.setFrequency(wobbleRate);
+    wobbleLFO.reset();
 
     // Prepare buffers
-    delayBuffer.setSize(2, samplesPerBlock);
-    wetBuffer.setSize(2, samplesPerBlock);
+    delayBuffer.setSize(2, maxTapeBlockSize);
+    wetBuffer.setSize(2, maxTapeBlockSize);
+    wowBuffer.setSize(2, maxTapeBlockSize);
+    flutterBuffer.setSize(2, maxTapeBlockSize);
+    reverbBuffer.setSize(2, samplesPerBlock);
+    wobbleBuffer.setSize(1, samplesPerBlock);
+    tapeInputFrames.assign(static_cast<size_t>(maxTapeBlockSize), TapeFrame{});
+    tapeDelayFrames.assign(static_cast<size_t>(maxTapeBlockSize), TapeFrame{});
+    fadeDelayFrames.assign(static_cast<size_t>(maxTapeBlockSize), TapeFrame{});
+    tapeOutputFrames.assign(static_cast<size_t>(maxTapeBlockSize), TapeFrame{});
+    crossfadeRamp.assign(static_cast<size_t>(maxTapeBlockSize), 0.0f);
+
+    wowLFO.reset();
+    flutterLFO.reset();
+
+    // Hosts switch to an offline render before preparing for it, so the
+    // profile's oversampling is taken here and holds until the next prepare:
+    // a profile switch never changes the latency in the middle of a stream
+    preparedRenderMode = getRenderMode();
+
+    // LFOs, feedback filter and the tape smoothers run at the tape rate
+    setTapeOversampling(captureParameters().oversamplingLog2);
+}
+
+void WalrusDelay1AudioProcessor::setTapeOversampling(int factorLog2)
+{
+    tapeOversamplingLog2 = juce::jlimit(0, maxOversamplingLog2, factorLog2);
+    tapeSampleRate = currentSampleRate * (1 << tapeOversamplingLog2);
+
+    // What is on the tape was recorded at the old rate, so there is nothing
+    // left to fade from either
+    tapeDelay.reset();
+    crossfadeRemaining = 0;
+    tapeDelay.setMaximumDelay(maxDelaySamples << tapeOversamplingLog2);
+
+    // Prepare LFOs (the phase carries on at the new rate)
+    wowLFO.prepare(tapeSampleRate);
+    flutterLFO.prepare(tapeSampleRate);
+    wowLFO.setFrequency(wowRateParam->get());
+    flutterLFO.setFrequency(flutterRateParam->get() * 2.0f);
+
+    // Prepare filter
+    feedbackFilter.prepare(tapeSampleRate);
+    feedbackSVF.prepare(tapeSampleRate);
+    tapeDelay.setSampleRate(tapeSampleRate);
+
+    // reset() keeps the target, so only the ramp lengths change
+    smoothers.reset(delayTimeSmoother, tapeSampleRate, 0.005);
+
+    smoothers.reset(feedbackSmoother, tapeSampleRate, 0.05);
+    smoothers.reset(dryWetSmoother, tapeSampleRate, 0.005);
+    smoothers.reset(filterFreqSmoother, tapeSampleRate, 0.05);
+    smoothers.reset(tapeLevelSmoother, tapeSampleRate, 0.01);
+
+    for (auto& oversampler : oversamplers)
+        oversampler->reset();
+
+    // Hosts are told from the calling thread; what they do with it is outside
+    // the allocation-free guarantee
+    AllocationTripwire::ScopedDisarm hostNotification;
+    setLatencySamples(getOversamplingLatency(tapeOversamplingLog2));
+}
+
+int WalrusDelay1AudioProcessor::getOversamplingLatency(int factorLog2) const
+{
+    return factorLog2 > 0 ? juce::roundToInt(oversamplers[static_cast<size_t>(factorLog2 - 1)]->getLatencyInSamples()) : 0;
 }
 
 void WalrusDelay1AudioProcessor::releaseResources()
 {
-    for (auto& delay : tapeDelays)
-    {
-        delay.reset();
-    }
+    tapeDelay.reset();
+
+    reverb.reset();
 }
 
 bool WalrusDelay1AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
@@ -140,9 +282,182 @@ bool WalrusDelay1AudioProcessor::isBusesLayoutSupported(const BusesLayout& layou
     return true;
 }
 
+template <typename Interpolator, typename Saturator>
+void WalrusDelay1AudioProcessor::processTapeDelay(const juce::AudioBuffer<float>& dryBuffer, int numChannels, const ParameterSnapshot& params,
+    const Saturator& saturate)
+{
+    const int numSamples = dryBuffer.getNumSamples();
+    const float wowScale = params.wowDepth * 0.1f;
+    const float flutterScale = params.flutterDepth * 0.05f;
+    const float msToSamples = static_cast<float>(tapeSampleRate / 1000.0);
+
+    // Both channels go through the tape core together, one frame per sample
+    std::array<const float*, numTapeLanes> inputData, wowData, flutterData;
+    std::array<float*, numTapeLanes> delayData, wetData;
+    for (int lane = 0; lane < numTapeLanes; ++lane)
+    {
+        const auto index = static_cast<size_t>(lane);
+        const int channel = juce::jmin(lane, numChannels - 1);
+        inputData[index] = dryBuffer.getReadPointer(channel);
+        wowData[index] = wowBuffer.getReadPointer(lane);
+        flutterData[index] = flutterBuffer.getReadPointer(lane);
+        delayData[index] = delayBuffer.getWritePointer(lane);
+        wetData[index] = wetBuffer.getWritePointer(lane);
+    }
+
+    const bool modulated = params.wowDepth != 0.0f || params.flutterDepth != 0.0f;
+    const int interval = modulated ? params.modulationInterval : numSamples;
+
+    // Incoming share of a delay crossfade for every sample of the block; past
+    // the end of the fade it stays at 1
+    const bool crossfading = crossfadeRemaining > 0;
+    if (crossfading)
+    {
+        const int fadeStart = crossfadeLength - crossfadeRemaining;
+        const float fadeScale = 1.0f / static_cast<float>(crossfadeLength);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+            crossfadeRamp[static_cast<size_t>(sample)] = juce::jmin(1.0f, static_cast<float>(fadeStart + sample + 1) * fadeScale);
+
+        crossfadeRemaining = juce::jmax(0, crossfadeRemaining - numSamples);
+    }
+
+    // Every lane reads the same ramps
+    const float* delayTimeRamp = smoothers.process(delayTimeSmoother, numSamples);
+    const float* feedbackRamp = smoothers.process(feedbackSmoother, numSamples);
+    const float* wetMixRamp = smoothers.process(dryWetSmoother, numSamples);
+    const float* filterFreqRamp = smoothers.process(filterFreqSmoother, numSamples);
+    const float* tapeLevelRamp = smoothers.process(tapeLevelSmoother, numSamples);
+
+    // The state-variable FilterModes filter the feedback path inside the tape
+    // core as well as the output below, so each repeat is filtered once more
+    // than the one before. Its resonance fits the highest feedback of the block
+    // under the loop-gain limit.
+    const float cutoffScale = params.psychedelicMode ? 1.5f : 1.0f;
+    const float loopResonance = getLimitedLoopResonance(params, juce::jmax(feedbackRamp[0], feedbackRamp[numSamples - 1]));
+    tapeDelay.setLoopFilter(params.filterMode, loopResonance, params.filterStages, filterFreqRamp, cutoffScale);
+
+    // Per-sample reference path: the delay time is recomputed every sample
+    if (interval == 1)
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const float baseDelayMs = delayTimeRamp[sample];
+            const float feedback = feedbackRamp[sample];
+
+            // Calculate modulated delay time
+            TapeFrame input, delaySamples, fadeDelay;
+            for (int lane = 0; lane < numTapeLanes; ++lane)
+            {
+                const auto index = static_cast<size_t>(lane);
+                const float modulation = 1.0f + wowData[index][sample] * wowScale + flutterData[index][sample] * flutterScale;
+                delaySamples[lane] = baseDelayMs * modulation * msToSamples;
+                fadeDelay[lane] = crossfadeFromMs * modulation * msToSamples;
+                input[lane] = inputData[index][sample];
+            }
+
+            tapeInputFrames[static_cast<size_t>(sample)] = input;
+
+            tapeOutputFrames[static_cast<size_t>(sample)] = crossfading
+                ? tapeDelay.process<Interpolator>(input, fadeDelay, delaySamples, crossfadeRamp[static_cast<size_t>(sample)], feedback, saturate, params.heads)
+                : tapeDelay.process<Interpolator>(input, delaySamples, feedback, saturate, params.heads);
+        }
+    }
+    else
+    {
+        // Control-rate path: wow and flutter come from the LFOs' control-rate
+        // output (table reads once per interval) and the tape core runs over
+        // segments of interval samples (the whole block without wow and
+        // flutter), reading and writing each as contiguous spans
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            const auto frame = static_cast<size_t>(sample);
+            for (int lane = 0; lane < numTapeLanes; ++lane)
+            {
+                const auto index = static_cast<size_t>(lane);
+                const float modulation = modulated
+                    ? 1.0f + wowData[index][sample] * wowScale + flutterData[index][sample] * flutterScale
+                    : 1.0f;
+                tapeInputFrames[frame][lane] = inputData[index][sample];
+                tapeDelayFrames[frame][lane] = delayTimeRamp[sample] * modulation * msToSamples;
+                fadeDelayFrames[frame][lane] = crossfadeFromMs * modulation * msToSamples;
+            }
+        }
+
+        for (int start = 0; start < numSamples; start += interval)
+        {
+            const int segmentSamples = juce::jmin(interval, numSamples - start);
+
+            if (crossfading)
+                tapeDelay.processBlock<Interpolator>(tapeInputFrames.data() + start, tapeOutputFrames.data() + start, segmentSamples,
+                    fadeDelayFrames.data() + start, tapeDelayFrames.data() + start, crossfadeRamp.data() + start, feedbackRamp + start,
+                    saturate, params.heads);
+            else
+                tapeDelay.processBlock<Interpolator>(tapeInputFrames.data() + start, tapeOutputFrames.data() + start, segmentSamples,
+                    tapeDelayFrames.data() + start, feedbackRamp + start, saturate, params.heads);
+        }
+    }
+
+    // The output filter follows the cutoff ramp at any interval. The idle
+    // filter is cleared, so switching FilterMode starts it from silence.
+    if (params.filterMode == FilterMode::onePole)
+    {
+        feedbackFilter.process(tapeOutputFrames.data(), tapeOutputFrames.data(), numSamples, filterFreqRamp, cutoffScale);
+        feedbackSVF.reset();
+    }
+    else
+    {
+        feedbackSVF.process(tapeOutputFrames.data(), tapeOutputFrames.data(), numSamples, filterFreqRamp, cutoffScale,
+            params.filterMode, params.filterResonance, params.filterStages);
+        feedbackFilter.reset();
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        const float wetMix = wetMixRamp[sample];
+        const float dryMix = 1.0f - wetMix;
+        const float tapeLevel = tapeLevelRamp[sample];
+        const auto& dry = tapeInputFrames[static_cast<size_t>(sample)];
+        const auto& delayed = tapeOutputFrames[static_cast<size_t>(sample)];
+
+        for (int lane = 0; lane < numTapeLanes; ++lane)
+        {
+            const float repeats = delayed[lane] * tapeLevel;
+            delayData[static_cast<size_t>(lane)][sample] = repeats;
+            wetData[static_cast<size_t>(lane)][sample] = dry[lane] * dryMix + repeats * wetMix;
+        }
+    }
+}
+
+template <SaturationAccuracy Accuracy>
+void WalrusDelay1AudioProcessor::processTapeDelayWithAccuracy(const juce::AudioBuffer<float>& dryBuffer, int numChannels,
+    const ParameterSnapshot& params)
+{
+    if (params.psychedelicMode)
+        processTapeDelayWithQuality(dryBuffer, numChannels, params, TubeWarmthSaturator<Accuracy>{ params.saturation * 1.5f });
+    else
+        processTapeDelayWithQuality(dryBuffer, numChannels, params, SoftClipSaturator<Accuracy>{ 1.0f + params.saturation * 0.5f });
+}
+
+template <typename Saturator>
+void WalrusDelay1AudioProcessor::processTapeDelayWithQuality(const juce::AudioBuffer<float>& dryBuffer, int numChannels,
+    const ParameterSnapshot& params, const Saturator& saturate)
+{
+    switch (params.interpolationQuality)
+    {
+        case InterpolationQuality::hermite:  processTapeDelay<HermiteInterpolation>(dryBuffer, numChannels, params, saturate); break;
+        case InterpolationQuality::lagrange: processTapeDelay<LagrangeInterpolation>(dryBuffer, numChannels, params, saturate); break;
+        case InterpolationQuality::allpass:  processTapeDelay<AllpassInterpolation>(dryBuffer, numChannels, params, saturate); break;
+        case InterpolationQuality::sinc:     processTapeDelay<SincInterpolation>(dryBuffer, numChannels, params, saturate); break;
+        case InterpolationQuality::linear:
+        default:                             processTapeDelay<LinearInterpolation>(dryBuffer, numChannels, params, saturate); break;
+    }
+}
+
 void WalrusDelay1AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
     juce::ScopedNoDenormals noDenormals;
+    AllocationTripwire::ScopedArm allocationTripwire;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     auto numSamples = buffer.getNumSamples();
@@ -151,173 +466,340 @@ void WalrusDelay1AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, numSamples);
 
-    // Update LFO frequencies
-    wowLFO.setFrequency(wowRateParam->get());
-    flutterLFO.setFrequency(flutterRateParam->get());
+    // Read every parameter once for this block
+    auto params = captureParameters();
+
+    // Synced delay time: the division at the host tempo, in the DelayTime range
+    if (params.delaySync)
+        params.delayTimeMs = tempoSync.getDelayMs(getPlayHead(), params.syncDivision, params.syncModifier,
+            delayTimeParam->range.start, delayTimeParam->range.end);
+
+    smoothers.setTargetValue(feedbackSmoother, getLimitedFeedback(params));
+    smoothers.setTargetValue(dryWetSmoother, params.dryWet);
+    smoothers.setTargetValue(reverbLevelSmoother, params.reverbLevel);
+    smoothers.setTargetValue(filterFreqSmoother, params.filterFreq);
+
+    // An oversampling change clears the tape (it was recorded at the old
+    // rate), so the repeats fade out over a few blocks first instead of
+    // stopping with a click. Nothing is heard from the tape while it is off
+    // or asleep, so then the change is immediate.
+    if (params.oversamplingLog2 != tapeOversamplingLog2)
+    {
+        if (sleeping || !params.tapeDelayOn || smoothers.getCurrentValue(tapeLevelSmoother) == 0.0f)
+        {
+            setTapeOversampling(params.oversamplingLog2);
+            smoothers.setCurrentAndTargetValue(tapeLevelSmoother, 1.0f);
+        }
+        else
+        {
+            smoothers.setTargetValue(tapeLevelSmoother, 0.0f);
+        }
+    }
+    else
+    {
+        smoothers.setTargetValue(tapeLevelSmoother, 1.0f);
+    }
+
+    // Slide ramps the delay time like a tape speed change; jump mode and
+    // synced times crossfade to the new delay
+    if (params.delaySync || params.delayJump)
+        startDelayCrossfade(params.delayTimeMs, params.crossfadeMs);
+    else
+        smoothers.setTargetValue(delayTimeSmoother, params.delayTimeMs);
+
+    // Asleep: stay silent until the input comes back
+    const float inputPeak = buffer.getMagnitude(0, numSamples);
+    if (sleeping)
+    {
+        if (inputPeak < silenceThreshold)
+        {
+            buffer.clear();
+            return;
+        }
+
+        sleeping = false;
+        silentSamples = 0;
+    }
 
-    // Update filter cutoff
-    float filterCutoff = smoothedFilterFreq.getNextValue();
-    if (psychedelicModeParam->get())
+    // Some hosts send more than the samplesPerBlock they announced
+    wetPeak = 0.0f;
+    for (int start = 0; start < numSamples; start += currentSamplesPerBlock)
     {
-        filterCutoff *= 1.5f;
+        const int chunkSamples = juce::jmin(currentSamplesPerBlock, numSamples - start);
+        juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(), totalNumInputChannels, start, chunkSamples);
+        processChunk(chunk, params);
     }
-    for (auto& filter : feedbackFilters)
+
+    // Once the input, everything recorded onto the tape and the reverb output
+    // have stayed silent for a whole loop, the stored signal is below the
+    // threshold too
+    silentSamples = juce::jmax(inputPeak, wetPeak) < silenceThreshold ? silentSamples + numSamples : 0;
+    if (silentSamples > getSleepDelaySamples(params))
+        enterSleep();
+}
+
+int WalrusDelay1AudioProcessor::getSleepDelaySamples(const ParameterSnapshot& params) const
+{
+    double loopMs = 0.0;
+
+    if (params.tapeDelayOn)
+        loopMs += juce::jmax(params.delayTimeMs, smoothers.getCurrentValue(delayTimeSmoother), crossfadeRemaining > 0 ? crossfadeFromMs : 0.0f)
+            * getMaximumModulation(params.wowDepth, params.flutterDepth);
+
+    // Longest FDN line, with margin
+    if (params.reverbOn)
+        loopMs += 100.0;
+
+    return static_cast<int>(loopMs * 0.001 * currentSampleRate) + currentSamplesPerBlock;
+}
+
+void WalrusDelay1AudioProcessor::enterSleep()
+{
+    sleeping = true;
+
+    // Whatever is left is below the threshold; clearing it now means the
+    // processor wakes up from a clean state
+    tapeDelay.reset();
+    feedbackFilter.reset();
+    feedbackSVF.reset();
+    reverb.reset();
+
+    for (auto& oversampler : oversamplers)
+        oversampler->reset();
+
+    for (int index = 0; index < numSmoothers; ++index)
+        smoothers.setCurrentAndTargetValue(index, smoothers.getTargetValue(index));
+
+    crossfadeRemaining = 0;
+}
+
+void WalrusDelay1AudioProcessor::startDelayCrossfade(float targetMs, float fadeMs)
+{
+    if (crossfadeRemaining > 0 || targetMs == smoothers.getTargetValue(delayTimeSmoother))
+        return;
+
+    // The outgoing reads carry on where the delay is now; the incoming ones
+    // start at the target straight away
+    crossfadeFromMs = smoothers.getCurrentValue(delayTimeSmoother);
+
+    smoothers.setCurrentAndTargetValue(delayTimeSmoother, targetMs);
+    crossfadeLength = juce::jmax(1, juce::roundToInt(fadeMs * 0.001 * tapeSampleRate));
+    crossfadeRemaining = crossfadeLength;
+    tapeDelay.beginCrossfade();
+}
+
+float WalrusDelay1AudioProcessor::getSaturatorSlope(float saturation, bool psychedelicMode)
+{
+    // Slope at zero of the saturators picked in processTapeDelayWithAccuracy
+    return psychedelicMode ? 1.0f + saturation * 1.5f : 1.0f + saturation * 0.5f;
+}
+
+float WalrusDelay1AudioProcessor::getLimitedFeedback(const ParameterSnapshot& params)
+{
+    const float loopGain = getSaturatorSlope(params.saturation, params.psychedelicMode) * params.heads.getFeedbackSendSum();
+    return loopGain > 0.0f ? juce::jmin(params.feedback, maxLoopGain / loopGain) : params.feedback;
+}
+
+float WalrusDelay1AudioProcessor::getLimitedLoopResonance(const ParameterSnapshot& params, float feedback)
+{
+    // feedback is the (already limited) Feedback the loop runs at
+    using Filter = LaneStateVariableFilter<numTapeLanes>;
+    const float loopGain = feedback * getSaturatorSlope(params.saturation, params.psychedelicMode) * params.heads.getFeedbackSendSum();
+
+    if (loopGain * Filter::getPeakGain(params.filterMode, params.filterResonance, params.filterStages) <= maxLoopGain)
+        return params.filterResonance;
+
+    // The peak grows with the resonance and is 1 at none, which the capped
+    // feedback always fits: bisect for the highest resonance that fits
+    float fits = 0.0f, tooHigh = params.filterResonance;
+    for (int step = 0; step < 16; ++step)
     {
-        filter.setCutoff(filterCutoff);
+        const float resonance = 0.5f * (fits + tooHigh);
+        if (loopGain * Filter::getPeakGain(params.filterMode, resonance, params.filterStages) <= maxLoopGain)
+            fits = resonance;
+        else
+            tooHigh = resonance;
     }
 
+    return fits;
+}
+
+double WalrusDelay1AudioProcessor::getMaximumModulation(float wowDepth, float flutterDepth)
+{
+    // Peak of the delay time modulation in processTapeDelay
+    return 1.0 + wowDepth * 0.1 + flutterDepth * 0.05;
+}
+
+void WalrusDelay1AudioProcessor::processChunk(juce::AudioBuffer<float>& buffer, const ParameterSnapshot& params)
+{
+    const int totalNumInputChannels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    const auto accuracy = params.saturationAccuracy;
+
+    // Update LFO frequencies
+    wowLFO.setFrequency(params.wowRate);
+    flutterLFO.setFrequency(params.flutterRate * 2.0f);
+
     // Clear buffers
     delayBuffer.clear();
     wetBuffer.clear();
 
+    // The tape loop works on the upsampled block when oversampling is on. The
+    // oversampler stays in the path while the tape is off as well, so toggling
+    // the tape does not change the latency.
+    auto* oversampler = tapeOversamplingLog2 > 0 ? oversamplers[static_cast<size_t>(tapeOversamplingLog2 - 1)].get() : nullptr;
+    juce::dsp::AudioBlock<float> hostBlock(buffer);
+    const auto tapeBlock = oversampler != nullptr ? oversampler->processSamplesUp(hostBlock) : hostBlock;
+
     // Process tape delay if enabled
-    if (tapeDelayOnOffParam->get())
+    if (params.tapeDelayOn)
     {
-        // Generate LFO modulation buffers
-        juce::AudioBuffer<float> wowBuffer(2, numSamples);
-        juce::AudioBuffer<float> flutterBuffer(2, numSamples);
+        const int tapeSamples = static_cast<int>(tapeBlock.getNumSamples());
 
-        // Fill LFO buffers
-        for (int channel = 0; channel < 2; ++channel)
-        {
-            auto* wowData = wowBuffer.getWritePointer(channel);
-            auto* flutterData = flutterBuffer.getWritePointer(channel);
+        jassert(totalNumInputChannels <= numTapeLanes);
+        std::array<float*, numTapeLanes> tapeChannels{};
+        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            tapeChannels[static_cast<size_t>(channel)] = tapeBlock.getChannelPointer(static_cast<size_t>(channel));
 
-            // Reset LFO phase for consistent stereo
-            wowLFO.reset();
-            flutterLFO.reset();
+        juce::AudioBuffer<float> tapeBuffer(tapeChannels.data(), totalNumInputChannels, tapeSamples);
 
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                wowData[sample] = wowLFO.processSample(0.0f);
-                flutterData[sample] = flutterLFO.processSample(0.0f);
-            }
+        // Fill LFO buffers, per sample or per control interval (see
+        // processTapeDelay); both lanes share the phase for consistent stereo
+        if (params.modulationInterval == 1)
+        {
+            wowLFO.process(wowBuffer.getArrayOfWritePointers(), tapeSamples);
+            flutterLFO.process(flutterBuffer.getArrayOfWritePointers(), tapeSamples);
         }
-
-        for (int channel = 0; channel < totalNumInputChannels; ++channel)
+        else
         {
-            auto* inputData = buffer.getReadPointer(channel);
-            auto* delayData = delayBuffer.getWritePointer(channel);
-            auto* wowData = wowBuffer.getReadPointer(channel);
-            auto* flutterData = flutterBuffer.getReadPointer(channel);
-
-            // Process each sample
-            for (int sample = 0; sample < numSamples; ++sample)
-            {
-                // Calculate modulated delay time
-                float baseDelayMs = smoothedDelayTime.getNextValue();
-                float wowMod = wowData[sample] * wowDepthParam->get() * 0.1f;
-                float flutterMod = flutterData[sample] * flutterDepthParam->get() * 0.05f;
-                float modulatedDelayMs = baseDelayMs * (1.0f + wowMod + flutterMod);
-                float modulatedDelaySamples = (modulatedDelayMs / 1000.0f) * currentSampleRate;
-
-                // Set delay time
-                tapeDelays[channel].setDelay(modulatedDelaySamples);
-
-                // Create saturation function
-                float saturationAmount = saturationParam->get();
-                auto saturationFunc = [saturationAmount, this](float x) -> float {
-                    if (psychedelicModeParam->get())
-                    {
-                        return TapeSaturation::tubeWarmth(x, saturationAmount * 1.5f);
-                    }
-                    else
-                    {
-                        return TapeSaturation::softClip(x * (1.0f + saturationAmount * 0.5f));
-                    }
-                    };
-
-                float input = inputData[sample];
-                float delayed = tapeDelays[channel].process(
-                    input,
-                    smoothedFeedback.getNextValue(),
-                    saturationFunc
-                );
-
-                delayed = feedbackFilters[channel].process(delayed);
-                delayData[sample] = delayed;
-
-                float dryMix = 1.0f - smoothedDryWet.getNextValue();
-                float wetMix = smoothedDryWet.getNextValue();
-                wetBuffer.setSample(channel, sample,
-                    input * dryMix + delayed * wetMix);
-            }
+            wowLFO.processControlRate(wowBuffer.getArrayOfWritePointers(), tapeSamples, params.modulationInterval);
+            flutterLFO.processControlRate(flutterBuffer.getArrayOfWritePointers(), tapeSamples, params.modulationInterval);
         }
 
+        // Pick the saturation curve and accuracy once for the whole block
+        if (accuracy == SaturationAccuracy::fast)
+            processTapeDelayWithAccuracy<SaturationAccuracy::fast>(tapeBuffer, totalNumInputChannels, params);
+        else
+            processTapeDelayWithAccuracy<SaturationAccuracy::exact>(tapeBuffer, totalNumInputChannels, params);
+
         // Copy wet buffer to main buffer
         for (int channel = 0; channel < totalNumInputChannels; ++channel)
         {
-            buffer.copyFrom(channel, 0, wetBuffer, channel, 0, numSamples);
+            tapeBuffer.copyFrom(channel, 0, wetBuffer, channel, 0, tapeSamples);
         }
+
+        // The peak recorded onto the tape, not the heard output: the output
+        // filter and head gains can hide echoes still going round the loop
+        wetPeak = juce::jmax(wetPeak, tapeDelay.takeRecordedPeak());
     }
 
-    // Process reverb if enabled (simplified reverb)
-    if (reverbOnOffParam->get())
+    if (oversampler != nullptr)
+        oversampler->processSamplesDown(hostBlock);
+
+    // Process reverb if enabled
+    if (params.reverbOn)
     {
-        float reverbMix = smoothedReverbLevel.getNextValue();
-        if (psychedelicModeParam->get())
-        {
-            reverbMix *= 1.2f;
-        }
+        const float* reverbLevelRamp = smoothers.process(reverbLevelSmoother, numSamples);
+        const float reverbScale = params.psychedelicMode ? 1.2f : 1.0f;
 
-        // Simple feedback delay for reverb
-        static std::array<juce::dsp::DelayLine<float>, 2> reverbDelays;
-        static bool reverbInitialized = false;
-
-        if (!reverbInitialized)
-        {
-            for (auto& delay : reverbDelays)
-            {
-                delay.prepare({ currentSampleRate, static_cast<juce::uint32>(currentSamplesPerBlock), 2 });
-                delay.setMaximumDelayInSamples(static_cast<int>(currentSampleRate * 0.1f)); // 100ms
-                delay.reset();
-            }
-            reverbInitialized = true;
-        }
+        reverb.setDecayTime(params.psychedelicMode ? psychedelicReverbDecaySeconds : reverbDecaySeconds);
+        reverb.process(buffer.getReadPointer(0), buffer.getReadPointer(totalNumInputChannels > 1 ? 1 : 0),
+            reverbBuffer.getWritePointer(0), reverbBuffer.getWritePointer(1), numSamples);
+        wetPeak = juce::jmax(wetPeak, reverbBuffer.getMagnitude(0, numSamples));
 
         for (int channel = 0; channel < totalNumInputChannels; ++channel)
         {
             auto* data = buffer.getWritePointer(channel);
-            auto& reverbDelay = reverbDelays[channel];
+            auto* reverbData = reverbBuffer.getReadPointer(channel);
 
             for (int sample = 0; sample < numSamples; ++sample)
             {
-                float input = data[sample];
-                float reverbOut = reverbDelay.popSample(channel, 80.0f, true); // 80 sample delay
-                reverbDelay.pushSample(channel, input + reverbOut * 0.6f);
-                data[sample] = input * (1.0f - reverbMix) + reverbOut * reverbMix;
+                const float reverbMix = reverbLevelRamp[sample] * reverbScale;
+                data[sample] = data[sample] * (1.0f - reverbMix) + reverbData[sample] * reverbMix;
             }
         }
     }
 
     // Apply psychedelic mode effects
-    if (psychedelicModeParam->get())
+    if (params.psychedelicMode)
     {
-        auto& random = juce::Random::getSystemRandom();
+        // Very subtle wobble, one LFO shared by both channels
+        wobbleLFO.process(wobbleBuffer.getArrayOfWritePointers(), numSamples);
+        const float* wobble = wobbleBuffer.getReadPointer(0);
+
         for (int channel = 0; channel < totalNumInputChannels; ++channel)
         {
             auto* data = buffer.getWritePointer(channel);
+
+            // Subtle tape noise
+            tapeHiss.process(channel, data, numSamples, params.hissColour, hissLevel);
+
+            // Gentle tape compression
+            if (accuracy == SaturationAccuracy::fast)
+                SaturationKernels::tanhCompress<SaturationAccuracy::fast>(data, numSamples, 0.8f);
+            else
+                SaturationKernels::tanhCompress<SaturationAccuracy::exact>(data, numSamples, 0.8f);
+
             for (int sample = 0; sample < numSamples; ++sample)
-            {
-                // Subtle tape noise
-                float noise = (random.nextFloat() - 0.5f) * 0.0002f;
-                data[sample] += noise;
-
-                // Gentle tape compression
-                data[sample] = std::tanh(data[sample] * 0.8f) / 0.8f;
-
-                // Very subtle pitch wobble
-                static float phase = 0.0f;
-                float wobble = std::sin(phase) * 0.002f;
-                data[sample] *= (1.0f + wobble);
-                phase += 0.5f * 2.0f * juce::MathConstants<float>::pi / currentSampleRate;
-                if (phase > 2.0f * juce::MathConstants<float>::pi)
-                    phase -= 2.0f * juce::MathConstants<float>::pi;
-            }
+                data[sample] *= 1.0f + wobble[sample] * wobbleDepth;
         }
     }
 }
 
+WalrusDelay1AudioProcessor::ParameterSnapshot WalrusDelay1AudioProcessor::captureParameters() const
+{
+    ParameterSnapshot params;
+    params.delayTimeMs = delayTimeParam->get();
+    params.feedback = feedbackParam->get();
+    params.wowRate = wowRateParam->get();
+    params.wowDepth = wowDepthParam->get();
+    params.flutterRate = flutterRateParam->get();
+    params.flutterDepth = flutterDepthParam->get();
+    params.dryWet = dryWetParam->get();
+    params.reverbLevel = reverbLevelParam->get();
+    params.filterFreq = filterFreqParam->get();
+    params.filterMode = static_cast<FilterMode>(filterModeParam->getIndex());
+    params.filterResonance = filterResonanceParam->get();
+    params.filterStages = filterSlopeParam->getIndex() + 1;
+    params.saturation = saturationParam->get();
+    params.tapeDelayOn = tapeDelayOnOffParam->get();
+    params.reverbOn = reverbOnOffParam->get();
+    params.psychedelicMode = psychedelicModeParam->get();
+    params.hissColour = static_cast<HissColour>(hissColourParam->getIndex());
+    params.delaySync = delaySyncParam->get();
+    params.syncDivision = static_cast<SyncDivision>(syncDivisionParam->getIndex());
+    params.syncModifier = static_cast<SyncModifier>(syncModifierParam->getIndex());
+    params.delayJump = delayModeParam->getIndex() == 1;
+    params.crossfadeMs = crossfadeTimeParam->get();
+    params.modulationInterval = modulationInterval.load();
+
+    // Head 1 plays at the delay time, the others evenly spaced before it. Pan
+    // is a balance between the two lanes.
+    static_assert(numTapeLanes == 2, "head pan assumes a stereo tape");
+    params.heads.numHeads = headsParam->get();
+    for (int head = 0; head < params.heads.numHeads; ++head)
+    {
+        const auto index = static_cast<size_t>(head);
+        const float level = headLevelParams[index]->get();
+        const float pan = headPanParams[index]->get();
+
+        params.heads.delayRatio[index] = static_cast<float>(params.heads.numHeads - head) / static_cast<float>(params.heads.numHeads);
+        params.heads.outputGain[index][0] = level * juce::jmin(1.0f, 1.0f - pan);
+        params.heads.outputGain[index][1] = level * juce::jmin(1.0f, 1.0f + pan);
+        params.heads.feedbackSend[index] = headFeedbackParams[index]->get();
+    }
+
+    // The render profile can only raise the oversampling and quality. The
+    // oversampling follows the profile prepareToPlay ran with, see there.
+    const auto& profile = renderProfiles[static_cast<size_t>(getRenderMode())];
+    params.oversamplingLog2 = juce::jmax(oversamplingParam->getIndex(),
+        renderProfiles[static_cast<size_t>(preparedRenderMode)].minimumOversamplingLog2.load());
+    params.interpolationQuality = static_cast<InterpolationQuality>(
+        juce::jmax(qualityParam->getIndex(), static_cast<int>(profile.minimumQuality.load())));
+    params.saturationAccuracy = profile.saturationAccuracy;
+    return params;
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout WalrusDelay1AudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
@@ -378,6 +860,81 @@ juce::AudioProcessorValueTreeState::ParameterLayout WalrusDelay1AudioProcessor::
     layout.add(std::make_unique<juce::AudioParameterBool>("ReverbOnOff", "Reverb", false));
     layout.add(std::make_unique<juce::AudioParameterBool>("PsychedelicMode", "Psychedelic Mode", false));
 
+    // Runs the tape loop (and its saturation) at 2x / 4x; adds latency
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Oversampling", "Oversampling",
+        juce::StringArray{ "Off", "2x", "4x" }, 0));
+
+    // Fractional-delay interpolation of the tape read head, in InterpolationQuality order
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Quality", "Quality",
+        juce::StringArray{ "Linear", "Hermite", "Lagrange", "Allpass", "Sinc" }, 0));
+
+    // Playback heads on the one tape loop. Head 1 sits at the delay time and
+    // carries the feedback by default; extra heads add earlier echoes.
+    layout.add(std::make_unique<juce::AudioParameterInt>("Heads", "Heads", 1, maxTapeHeads, 1));
+
+    const auto panAttributes = juce::AudioParameterFloatAttributes().withStringFromValueFunction(
+        [](float value, int)
+        {
+            const int amount = juce::roundToInt(std::abs(value) * 100.0f);
+            return amount == 0 ? juce::String("C") : (value < 0.0f ? "L" : "R") + juce::String(amount);
+        });
+
+    for (int head = 1; head <= maxTapeHeads; ++head)
+    {
+        const auto id = "Head" + juce::String(head);
+        const auto name = "Head " + juce::String(head);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(id + "Level", name + " Level",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f,
+            percentageAttributes));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(id + "Pan", name + " Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f,
+            panAttributes));
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(id + "Feedback", name + " Feedback",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), head == 1 ? 1.0f : 0.0f,
+            percentageAttributes));
+    }
+
+    // Tempo sync: the delay time follows a note division of the host tempo
+    // instead of DelayTime, crossfading when the tempo changes
+    layout.add(std::make_unique<juce::AudioParameterBool>("DelaySync", "Delay Sync", false));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("SyncDivision", "Sync Division",
+        juce::StringArray{ "1/32", "1/16", "1/8", "1/4", "1/2", "1/1", "1 Bar" }, 3));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("SyncModifier", "Sync Modifier",
+        juce::StringArray{ "Straight", "Dotted", "Triplet" }, 0));
+
+    // How DelayTime changes are followed: Slide ramps the delay (the pitch
+    // bends like a tape speed change), Jump crossfades from the old to the new
+    // delay over CrossfadeTime, which tempo sync uses as well
+    layout.add(std::make_unique<juce::AudioParameterChoice>("DelayMode", "Delay Mode",
+        juce::StringArray{ "Slide", "Jump" }, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("CrossfadeTime", "Crossfade Time",
+        juce::NormalisableRange<float>(5.0f, 500.0f, 1.0f, 0.5f), 50.0f,
+        juce::AudioParameterFloatAttributes().withStringFromValueFunction(
+            [](float value, int) { return juce::String((int)value) + " ms"; })));
+
+    // Spectrum of the psychedelic mode tape hiss
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HissColour", "Hiss Colour",
+        juce::StringArray{ "White", "Pink", "Brown" }, 0));
+
+    // Response of the filter on the repeats, in FilterMode order: Tape is the
+    // gentle 1-pole low-pass, the others a resonant state-variable filter
+    // whose Slope cascades a second stage
+    layout.add(std::make_unique<juce::AudioParameterChoice>("FilterMode", "Filter Mode",
+        juce::StringArray{ "Tape", "Low Pass", "Band Pass", "High Pass" }, 0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>("FilterResonance", "Filter Resonance",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f,
+        percentageAttributes));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice>("FilterSlope", "Filter Slope",
+        juce::StringArray{ "12 dB/oct", "24 dB/oct" }, 0));
+
     return layout;
 }
 
@@ -393,8 +950,13 @@ bool WalrusDelay1AudioProcessor::hasEditor() const
 
 void WalrusDelay1AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    auto state = apvts.copyState();
+    state.removeChild(state.getChildWithName("RenderProfiles"), nullptr);
+    state.appendChild(writeRenderProfiles(), nullptr);
+    state.setProperty("TapeStorage", getTapeStorageFormatName(tapeStorageFormat), nullptr);
+
     juce::MemoryOutputStream mos(destData, true);
-    apvts.state.writeToStream(mos);
+    state.writeToStream(mos);
 }
 
 void WalrusDelay1AudioProcessor::setStateInformation(const void* data, int sizeInBytes)
@@ -402,8 +964,106 @@ void WalrusDelay1AudioProcessor::setStateInformation(const void* data, int sizeI
     auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
     if (tree.isValid())
     {
+        // Sessions saved before the profiles existed get the defaults
+        readRenderProfiles(tree.getChildWithName("RenderProfiles"));
+
+        // prepareToPlay below reallocates the loop in this format, so the
+        // audio callback is held off as in setTapeStorageFormat
+        const bool wasSuspended = isSuspended();
+        suspendProcessing(true);
+
+        tapeStorageFormat = getTapeStorageFormatFromName(tree.getProperty("TapeStorage", "float32").toString());
         apvts.replaceState(tree);
         prepareToPlay(currentSampleRate, currentSamplesPerBlock);
+
+        suspendProcessing(wasSuspended);
+    }
+}
+
+//==============================================================================
+void WalrusDelay1AudioProcessor::setTapeStorageFormat(TapeStorageFormat newFormat)
+{
+    if (newFormat == tapeStorageFormat)
+        return;
+
+    tapeStorageFormat = newFormat;
+
+    // Not prepared yet: prepareToPlay picks the format up
+    if (maxDelaySamples == 0)
+        return;
+
+    // Holds the audio callback off while the loop is reallocated; the
+    // recorded audio is lost with the old buffer
+    const bool wasSuspended = isSuspended();
+    suspendProcessing(true);
+
+    tapeDelay.prepare(maxDelaySamples << maxOversamplingLog2, currentSamplesPerBlock << maxOversamplingLog2, newFormat);
+    tapeDelay.setMaximumDelay(maxDelaySamples << tapeOversamplingLog2);
+
+    suspendProcessing(wasSuspended);
+}
+
+WalrusDelay1AudioProcessor::RenderProfile WalrusDelay1AudioProcessor::getDefaultRenderProfile(RenderMode mode)
+{
+    RenderProfile profile;
+
+    if (mode == RenderMode::offline)
+    {
+        profile.minimumOversamplingLog2 = maxOversamplingLog2;
+        profile.minimumQuality = InterpolationQuality::sinc;
+        profile.saturationAccuracy = SaturationAccuracy::exact;
+    }
+
+    return profile;
+}
+
+void WalrusDelay1AudioProcessor::setRenderProfile(RenderMode mode, const RenderProfile& newProfile)
+{
+    auto& profile = renderProfiles[static_cast<size_t>(mode)];
+    profile.minimumOversamplingLog2 = juce::jlimit(0, maxOversamplingLog2, newProfile.minimumOversamplingLog2);
+    profile.minimumQuality = newProfile.minimumQuality;
+    profile.saturationAccuracy = newProfile.saturationAccuracy;
+}
+
+WalrusDelay1AudioProcessor::RenderProfile WalrusDelay1AudioProcessor::getRenderProfile(RenderMode mode) const
+{
+    const auto& profile = renderProfiles[static_cast<size_t>(mode)];
+    return { profile.minimumOversamplingLog2, profile.minimumQuality, profile.saturationAccuracy };
+}
+
+juce::ValueTree WalrusDelay1AudioProcessor::writeRenderProfiles() const
+{
+    juce::ValueTree profiles("RenderProfiles");
+
+    for (auto mode : { RenderMode::realtime, RenderMode::offline })
+    {
+        const auto profile = getRenderProfile(mode);
+
+        juce::ValueTree child(mode == RenderMode::realtime ? "Realtime" : "Offline");
+        child.setProperty("Oversampling", profile.minimumOversamplingLog2, nullptr);
+        child.setProperty("Quality", static_cast<int>(profile.minimumQuality), nullptr);
+        child.setProperty("Saturation", profile.saturationAccuracy == SaturationAccuracy::exact ? "exact" : "fast", nullptr);
+        profiles.appendChild(child, nullptr);
+    }
+
+    return profiles;
+}
+
+void WalrusDelay1AudioProcessor::readRenderProfiles(const juce::ValueTree& profiles)
+{
+    for (auto mode : { RenderMode::realtime, RenderMode::offline })
+    {
+        const auto child = profiles.getChildWithName(mode == RenderMode::realtime ? "Realtime" : "Offline");
+        const auto defaults = getDefaultRenderProfile(mode);
+
+        RenderProfile profile;
+        profile.minimumOversamplingLog2 = child.getProperty("Oversampling", defaults.minimumOversamplingLog2);
+        profile.minimumQuality = static_cast<InterpolationQuality>(juce::jlimit(0, static_cast<int>(InterpolationQuality::sinc),
+            static_cast<int>(child.getProperty("Quality", static_cast<int>(defaults.minimumQuality)))));
+        profile.saturationAccuracy = child.getProperty("Saturation", defaults.saturationAccuracy == SaturationAccuracy::exact ? "exact" : "fast")
+            .toString() == "exact" ? SaturationAccuracy::exact : SaturationAccuracy::fast;
+
+        setRenderProfile(mode, profile);
     }
 }
 
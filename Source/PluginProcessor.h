@@ -12,6 +12,12 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "TapeDSP.h"
+#include "TempoSync.h"
+#include "SmootherBank.h"
+#include "NoiseGenerator.h"
+#include "FDNReverb.h"
+#include "AllocationTripwire.h"
 
 
 class WalrusDelay1AudioProcessor : public juce::AudioProcessor
@@ -52,120 +58,197 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     //==============================================================================
-    juce::AudioProcessorValueTreeState apvts;
-
-private:
-    //==============================================================================
-    class TapeDelayLine
+    // Engine settings that depend on whether the host plays live or bounces
+    // (isNonRealtime()). The Oversampling and Quality parameters act as a floor
+    // that a profile can only raise. Both profiles are saved with the state.
+    enum class RenderMode
     {
-    public:
-        TapeDelayLine() = default;
-        ~TapeDelayLine() = default;
-
-        void prepare(double sampleRate, int maximumDelaySamples)
-        {
-            delayLine.prepare({ sampleRate, static_cast<juce::uint32>(512), 2 });
-            delayLine.setMaximumDelayInSamples(maximumDelaySamples);
-            delayLine.reset();
-        }
-
-        void setDelay(float delayInSamples)
-        {
-            currentDelay = juce::jlimit(1.0f, static_cast<float>(delayLine.getMaximumDelayInSamples()), delayInSamples);
-        }
-
-        float process(float input, float feedback, const std::function<float(float)>& saturationFunc)
-        {
-            float delayed = delayLine.popSample(0, currentDelay, true);
-            delayed = saturationFunc(delayed);
-            float feedbackSample = delayed * feedback;
-            delayLine.pushSample(0, input + feedbackSample);
-            return delayed;
-        }
-
-        void reset()
-        {
-            delayLine.reset();
-        }
-
-    private:
-        juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
-        float currentDelay = 1000.0f;
+        realtime,
+        offline
     };
 
-    // Tape saturation
-    struct TapeSaturation
+    struct RenderProfile
     {
-        static float softClip(float x)
-        {
-            if (x > 0.0f)
-                return 1.0f - std::exp(-x);
-            else
-                return -1.0f + std::exp(x);
-        }
-
-        static float tubeWarmth(float x, float drive = 0.7f)
-        {
-            float sign = x < 0.0f ? -1.0f : 1.0f;
-            return sign * (1.0f - std::exp(-std::abs(x) * (1.0f + drive)));
-        }
-    };
+        int minimumOversamplingLog2 = 0;
+        InterpolationQuality minimumQuality = InterpolationQuality::linear;
 
-    // Simple 1-pole low-pass filter for feedback path
-    class SimpleLowPassFilter
-    {
-    public:
-        void prepare(double sampleRate)
-        {
-            sr = static_cast<float>(sampleRate);
-            reset();
-        }
-
-        void reset()
-        {
-            z1 = 0.0f;
-        }
-
-        void setCutoff(float freq)
-        {
-            freq = juce::jlimit(20.0f, 20000.0f, freq);
-            float omega = 2.0f * juce::MathConstants<float>::pi * freq / sr;
-            // Simple 1-pole filter coefficient
-            a = std::exp(-omega);
-            b = 1.0f - a;
-        }
-
-        float process(float input)
-        {
-            float output = b * input + a * z1;
-            z1 = output;
-            return output;
-        }
-
-    private:
-        float sr = 44100.0f;
-        float a = 0.0f; // Feedback coefficient
-        float b = 1.0f; // Feedforward coefficient
-        float z1 = 0.0f; // Delay element
+        // Fast uses the polynomial kernels, exact the std::exp / std::tanh
+        // reference; see SaturationKernels.h for the error bounds
+        SaturationAccuracy saturationAccuracy = SaturationAccuracy::fast;
     };
 
+    // Realtime: parameters as set, fast kernels. Offline: at least 4x, sinc
+    // interpolation, exact kernels.
+    static RenderProfile getDefaultRenderProfile(RenderMode mode);
+
+    void setRenderProfile(RenderMode mode, const RenderProfile& newProfile);
+    RenderProfile getRenderProfile(RenderMode mode) const;
+    RenderMode getRenderMode() const { return isNonRealtime() ? RenderMode::offline : RenderMode::realtime; }
+
+    // Sample format the tape loop is recorded in, see TapeStorage.h. Changing
+    // it reallocates the loop, so it is a setting saved with the state rather
+    // than an automatable parameter, and processing is suspended meanwhile.
+    void setTapeStorageFormat(TapeStorageFormat newFormat);
+    TapeStorageFormat getTapeStorageFormat() const { return tapeStorageFormat; }
+    size_t getTapeStorageSizeInBytes() const { return tapeDelay.getStorageSizeInBytes(); }
+
+    // The wow and flutter LFOs are read every `samples` samples of the tape
+    // loop and follow a cubic in between, and the tape core runs in spans of
+    // that length; 1 runs everything per sample (the reference path)
+    void setModulationInterval(int samples) { modulationInterval = juce::jlimit(1, 256, samples); }
+    int getModulationInterval() const { return modulationInterval; }
+
+    // True while processBlock is skipping the DSP after the tail has died away
+    bool isSleeping() const { return sleeping; }
+
+    //==============================================================================
+    juce::AudioProcessorValueTreeState apvts;
+
+private:
     // Parameter Layout
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    // DSP Members
-    std::array<TapeDelayLine, 2> tapeDelays;
-    std::array<SimpleLowPassFilter, 2> feedbackFilters;
+    // Tape core: one lane per channel, up to maxTapeHeads playback heads
+    static constexpr int numTapeLanes = 2;
+    static constexpr int maxTapeHeads = 4;
+    using TapeLoop = TapeDelayLine<numTapeLanes, maxTapeHeads>;
+    using TapeFrame = TapeLoop::Frame;
+    using TapeHeads = TapeLoop::Heads;
 
-    // LFOs for modulation
-    juce::dsp::Oscillator<float> wowLFO{ [](float x) { return std::sin(x); } };
-    juce::dsp::Oscillator<float> flutterLFO{ [](float x) { return std::sin(x * 2.0f); } };
+    // Parameter values read once at the top of processBlock. The DSP reads only
+    // from here; changes within a block are ramped by the smoothers.
+    struct ParameterSnapshot
+    {
+        float delayTimeMs = 500.0f; // the synced time in DelaySync mode, see processBlock
+        float feedback = 0.5f;
+        float wowRate = 0.5f;
+        float wowDepth = 0.3f;
+        float flutterRate = 15.0f;
+        float flutterDepth = 0.15f;
+        float dryWet = 0.5f;
+        float reverbLevel = 0.3f;
+        float filterFreq = 4000.0f;
+        FilterMode filterMode = FilterMode::onePole;
+        float filterResonance = 0.0f;
+        int filterStages = 1; // FilterSlope: 12 or 24 dB/oct
+        float saturation = 0.4f;
+        bool tapeDelayOn = true;
+        bool reverbOn = false;
+        bool psychedelicMode = false;
+        HissColour hissColour = HissColour::white;
+        bool delaySync = false;
+        bool delayJump = false; // DelayMode: slide (ramp) or jump (crossfade)
+        float crossfadeMs = 50.0f;
+        SyncDivision syncDivision = SyncDivision::quarter;
+        SyncModifier syncModifier = SyncModifier::straight;
+        TapeHeads heads; // from Heads and the HeadN parameters
+        int oversamplingLog2 = 0; // 0 = off, 1 = 2x, 2 = 4x
+        InterpolationQuality interpolationQuality = InterpolationQuality::linear;
+        SaturationAccuracy saturationAccuracy = SaturationAccuracy::fast;
+        int modulationInterval = 8; // from setModulationInterval
+    };
+
+    ParameterSnapshot captureParameters() const;
+
+    // Processes at most currentSamplesPerBlock samples; processBlock splits
+    // larger host buffers so the scratch buffers never need to grow
+    void processChunk(juce::AudioBuffer<float>& buffer, const ParameterSnapshot& params);
+
+    // Tape delay pass, instantiated once per interpolation / saturation pair
+    template <typename Interpolator, typename Saturator>
+    void processTapeDelay(const juce::AudioBuffer<float>& dryBuffer, int numChannels, const ParameterSnapshot& params,
+        const Saturator& saturate);
+
+    // Picks the saturation curve for the block, then the interpolator
+    template <SaturationAccuracy Accuracy>
+    void processTapeDelayWithAccuracy(const juce::AudioBuffer<float>& dryBuffer, int numChannels, const ParameterSnapshot& params);
+
+    // Picks the fractional-delay interpolator for the block, then runs processTapeDelay
+    template <typename Saturator>
+    void processTapeDelayWithQuality(const juce::AudioBuffer<float>& dryBuffer, int numChannels, const ParameterSnapshot& params,
+        const Saturator& saturate);
+
+    // Sleep mode: once the input, the tape recording and the reverb output
+    // have been below silenceThreshold for longer than a full loop,
+    // processBlock resets the DSP state and outputs silence until the input
+    // comes back
+    int getSleepDelaySamples(const ParameterSnapshot& params) const;
+    void enterSleep();
+
+    // Jump mode and DelaySync: moves to a new delay time by crossfading the
+    // tape reads over fadeMs instead of ramping the delay, so delay changes do
+    // not sweep the pitch. A fade in progress finishes first.
+    void startDelayCrossfade(float targetMs, float fadeMs);
+
+    // Peak factor wow and flutter apply to the delay time
+    static double getMaximumModulation(float wowDepth, float flutterDepth);
+
+    // Loop-gain limiter. The saturators amplify small signals by their slope
+    // at zero, so Feedback near the top of its range (or several heads
+    // feeding back) gives a loop gain above 1 and the repeats build up to the
+    // saturation ceiling. The Feedback the loop uses is capped, once per
+    // block through its smoother, so that feedback times the saturator slope
+    // times the summed head sends stays at maxLoopGain or below; settings
+    // under the cap are used as they are. A resonant loop filter only boosts
+    // a narrow band, so rather than lowering the feedback for every frequency
+    // the loop filter's resonance is lowered until its peak fits as well
+    // (the output filter keeps the full resonance).
+    static constexpr float maxLoopGain = 0.97f;
+    static float getSaturatorSlope(float saturation, bool psychedelicMode);
+    static float getLimitedFeedback(const ParameterSnapshot& params);
+    static float getLimitedLoopResonance(const ParameterSnapshot& params, float feedback);
+
+    // Switches the rate the tape loop runs at. Everything is sized for the
+    // highest factor in prepareToPlay, so this only resets state.
+    void setTapeOversampling(int factorLog2);
+
+    // Latency of the oversampler for a factor, reported for the one in use
+    int getOversamplingLatency(int factorLog2) const;
+
+    // DSP Members
+    TapeLoop tapeDelay;
+    LaneLowPassFilter<numTapeLanes> feedbackFilter;
+    LaneStateVariableFilter<numTapeLanes> feedbackSVF;
+
+    // The saturation sits inside the feedback loop, so the whole tape loop is
+    // oversampled rather than the saturator alone: oversamplers[0] is 2x,
+    // oversamplers[1] is 4x (polyphase IIR half-bands, integer latency)
+    static constexpr int maxOversamplingLog2 = 2;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOversamplingLog2> oversamplers;
+    int tapeOversamplingLog2 = 0;
+    double tapeSampleRate = 44100.0;
+    int maxDelaySamples = 0;
+    RenderMode preparedRenderMode = RenderMode::realtime;
+
+    // Tempo sync and the delay crossfade. The outgoing reads stay at
+    // crossfadeFromMs (modulated like the incoming ones) until
+    // crossfadeRemaining tape samples have played.
+    TempoSync tempoSync;
+    float crossfadeFromMs = 0.0f;
+    int crossfadeLength = 0;
+    int crossfadeRemaining = 0;
+
+    // LFOs for modulation, one lane per tape channel. Flutter runs at twice
+    // the FlutterRate value (its original waveform was sin(2x)).
+    LFOBank<numTapeLanes> wowLFO;
+    LFOBank<numTapeLanes> flutterLFO;
+
+    // Smoothing for parameters. The bank renders each ramp once per block for
+    // both channels; delay time, feedback, dry/wet and the filter cutoff run
+    // at the tape rate, the reverb level at the host rate. The tape level
+    // fades the repeats out before an oversampling change clears the loop.
+    enum Smoother
+    {
+        delayTimeSmoother,
+        feedbackSmoother,
+        dryWetSmoother,
+        reverbLevelSmoother,
+        filterFreqSmoother,
+        tapeLevelSmoother,
+        numSmoothers
+    };
 
-    // Smoothing for parameters
-    juce::LinearSmoothedValue<float> smoothedDelayTime{ 100.0f };
-    juce::LinearSmoothedValue<float> smoothedFeedback{ 0.5f };
-    juce::LinearSmoothedValue<float> smoothedDryWet{ 0.5f };
-    juce::LinearSmoothedValue<float> smoothedReverbLevel{ 0.0f };
-    juce::LinearSmoothedValue<float> smoothedFilterFreq{ 4000.0f };
+    SmootherBank<numSmoothers> smoothers;
 
     // Parameter pointers
     juce::AudioParameterFloat* delayTimeParam;
@@ -181,10 +264,70 @@ private:
     juce::AudioParameterBool* tapeDelayOnOffParam;
     juce::AudioParameterBool* reverbOnOffParam;
     juce::AudioParameterBool* psychedelicModeParam;
-
-    // Output buffers
+    juce::AudioParameterChoice* oversamplingParam;
+    juce::AudioParameterChoice* qualityParam;
+    juce::AudioParameterInt* headsParam;
+    std::array<juce::AudioParameterFloat*, maxTapeHeads> headLevelParams;
+    std::array<juce::AudioParameterFloat*, maxTapeHeads> headPanParams;
+    std::array<juce::AudioParameterFloat*, maxTapeHeads> headFeedbackParams;
+    juce::AudioParameterBool* delaySyncParam;
+    juce::AudioParameterChoice* syncDivisionParam;
+    juce::AudioParameterChoice* syncModifierParam;
+    juce::AudioParameterChoice* delayModeParam;
+    juce::AudioParameterFloat* crossfadeTimeParam;
+    juce::AudioParameterChoice* hissColourParam;
+    juce::AudioParameterChoice* filterModeParam;
+    juce::AudioParameterFloat* filterResonanceParam;
+    juce::AudioParameterChoice* filterSlopeParam;
+
+    // Reverb
+    FDNReverb<8> reverb;
+    static constexpr float reverbDecaySeconds = 1.8f;
+    static constexpr float psychedelicReverbDecaySeconds = 3.5f;
+
+    // Psychedelic mode tape hiss, seeded per instance
+    TapeHiss<2> tapeHiss;
+    static constexpr float hissLevel = 0.0001f;
+
+    // Psychedelic mode level wobble, at the host rate
+    LFOBank<1> wobbleLFO;
+    static constexpr float wobbleRate = 0.5f;
+    static constexpr float wobbleDepth = 0.002f;
+
+    // Sleep mode state
+    static constexpr float silenceThreshold = 1.0e-5f; // -100 dBFS
+    float wetPeak = 0.0f;
+    int silentSamples = 0;
+    bool sleeping = false;
+
+    // Scratch buffers, sized in prepareToPlay
     juce::AudioBuffer<float> delayBuffer;
     juce::AudioBuffer<float> wetBuffer;
+    juce::AudioBuffer<float> wowBuffer;
+    juce::AudioBuffer<float> flutterBuffer;
+    juce::AudioBuffer<float> reverbBuffer;
+    juce::AudioBuffer<float> wobbleBuffer;
+    std::vector<TapeFrame> tapeInputFrames;
+    std::vector<TapeFrame> tapeDelayFrames; // loop delay per sample, control-rate path
+    std::vector<TapeFrame> fadeDelayFrames; // outgoing crossfade delay per sample
+    std::vector<TapeFrame> tapeOutputFrames;
+    std::vector<float> crossfadeRamp;
+
+    // One per RenderMode; written on the message thread, read once per block
+    struct RenderProfileState
+    {
+        std::atomic<int> minimumOversamplingLog2{ 0 };
+        std::atomic<InterpolationQuality> minimumQuality{ InterpolationQuality::linear };
+        std::atomic<SaturationAccuracy> saturationAccuracy{ SaturationAccuracy::fast };
+    };
+
+    std::array<RenderProfileState, 2> renderProfiles;
+    std::atomic<TapeStorageFormat> tapeStorageFormat{ TapeStorageFormat::float32 };
+    std::atomic<int> modulationInterval{ 8 };
+
+    // Stored as a child of the apvts state
+    juce::ValueTree writeRenderProfiles() const;
+    void readRenderProfiles(const juce::ValueTree& profiles);
 
     // Sample rate
     double currentSampleRate = 44100.0;
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    SmootherBank.h
+    Created: 16 Oct 2026
+
+    Linear parameter smoothers whose ramps are rendered a block at a time.
+    Each smoother fills its own row of one buffer with the values for the
+    next numSamples samples, and every lane reads that row. This replaces a
+    getNextValue() call per sample and channel with one loop per block, and
+    both channels see the same ramp.
+
+    Same semantics as juce::LinearSmoothedValue: a new target starts a ramp
+    of rampLengthSeconds from the current value, and reset() snaps to the
+    target.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+template <int NumSmoothers>
+class SmootherBank
+{
+public:
+    void prepare(int maximumBlockSize)
+    {
+        maxBlockSize = maximumBlockSize;
+        ramps.assign(static_cast<size_t>(NumSmoothers * maximumBlockSize), 0.0f);
+    }
+
+    // Sets the ramp length and jumps to the target
+    void reset(int index, double sampleRate, double rampLengthSeconds) noexcept
+    {
+        auto& smoother = smoothers[static_cast<size_t>(index)];
+        smoother.rampSamples = static_cast<int>(std::floor(rampLengthSeconds * sampleRate));
+        setCurrentAndTargetValue(index, smoother.target);
+    }
+
+    void setCurrentAndTargetValue(int index, float value) noexcept
+    {
+        auto& smoother = smoothers[static_cast<size_t>(index)];
+        smoother.current = smoother.target = value;
+        smoother.step = 0.0f;
+        smoother.countdown = 0;
+    }
+
+    void setTargetValue(int index, float value) noexcept
+    {
+        auto& smoother = smoothers[static_cast<size_t>(index)];
+        if (value == smoother.target)
+            return;
+
+        if (smoother.rampSamples <= 0)
+        {
+            setCurrentAndTargetValue(index, value);
+            return;
+        }
+
+        smoother.target = value;
+        smoother.countdown = smoother.rampSamples;
+        smoother.step = (smoother.target - smoother.current) / static_cast<float>(smoother.countdown);
+    }
+
+    float getCurrentValue(int index) const noexcept { return smoothers[static_cast<size_t>(index)].current; }
+    float getTargetValue(int index) const noexcept { return smoothers[static_cast<size_t>(index)].target; }
+    bool isSmoothing(int index) const noexcept { return smoothers[static_cast<size_t>(index)].countdown > 0; }
+
+    // Renders the next numSamples values of one smoother into its row and
+    // advances it. The row stays valid until that smoother is processed again.
+    const float* process(int index, int numSamples) noexcept
+    {
+        jassert(numSamples <= maxBlockSize);
+
+        auto& smoother = smoothers[static_cast<size_t>(index)];
+        float* ramp = ramps.data() + index * maxBlockSize;
+
+        // The sample that ends the ramp is the target itself, as in
+        // LinearSmoothedValue
+        const int rampSamples = juce::jlimit(0, numSamples, smoother.countdown - 1);
+        const float start = smoother.current;
+        const float step = smoother.step;
+
+        for (int i = 0; i < rampSamples; ++i)
+            ramp[i] = start + step * static_cast<float>(i + 1);
+
+        std::fill(ramp + rampSamples, ramp + numSamples, smoother.target);
+
+        smoother.countdown = juce::jmax(0, smoother.countdown - numSamples);
+        smoother.current = smoother.countdown > 0 ? start + step * static_cast<float>(numSamples) : smoother.target;
+        return ramp;
+    }
+
+private:
+    struct Smoother
+    {
+        float current = 0.0f;
+        float target = 0.0f;
+        float step = 0.0f;
+        int countdown = 0;
+        int rampSamples = 0;
+    };
+
+    std::array<Smoother, static_cast<size_t>(NumSmoothers)> smoothers;
+    std::vector<float> ramps;
+    int maxBlockSize = 0;
+};
@@ -0,0 +1,1543 @@
+/*
+  ==============================================================================
+
+    TapeDSP.h
+    Created: 16 Oct 2026
+
+    Building blocks of the tape delay path, kept outside the processor so the
+    benchmarks and tools can drive them in isolation.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "SaturationKernels.h"
+#include "TapeStorage.h"
+
+//==============================================================================
+// One sample of every channel (lane) processed together by the tape core
+template <int NumLanes>
+struct alignas(NumLanes * sizeof(float)) TapeFrame
+{
+    static_assert(NumLanes > 0 && (NumLanes & (NumLanes - 1)) == 0, "NumLanes must be a power of two");
+
+    float lanes[static_cast<size_t>(NumLanes)] = {};
+
+    float& operator[](int lane) noexcept { return lanes[lane]; }
+    float operator[](int lane) const noexcept { return lanes[lane]; }
+};
+
+//==============================================================================
+// Power-of-two circular buffer: indices wrap with a mask instead of a modulo.
+// Blocks can be read or written as at most two contiguous spans (split once at
+// the wrap point), so unmodulated delays can move whole blocks with memcpy.
+template <typename T>
+class CircularBuffer
+{
+public:
+    struct Spans
+    {
+        T* first = nullptr;
+        int firstSize = 0;
+        T* second = nullptr;
+        int secondSize = 0;
+    };
+
+    // Allocates at least minimumLength elements, rounded up to a power of two
+    void setSize(int minimumLength)
+    {
+        length = juce::nextPowerOfTwo(juce::jmax(2, minimumLength));
+        mask = length - 1;
+        buffer.assign(static_cast<size_t>(length), T{});
+        writeIndex = 0;
+    }
+
+    void clear()
+    {
+        std::fill(buffer.begin(), buffer.end(), T{});
+        writeIndex = 0;
+    }
+
+    int getLength() const noexcept { return length; }
+    int getWriteIndex() const noexcept { return writeIndex; }
+
+    // Element written `delay` writes ago (delay 1 = the most recent one)
+    const T& getDelayed(int delay) const noexcept { return buffer[static_cast<size_t>((writeIndex - delay) & mask)]; }
+
+    // Element at any (possibly negative or past-the-end) absolute index
+    const T& getWrapped(int index) const noexcept { return buffer[static_cast<size_t>(index & mask)]; }
+
+    void write(const T& element) noexcept
+    {
+        buffer[static_cast<size_t>(writeIndex)] = element;
+        writeIndex = (writeIndex + 1) & mask;
+    }
+
+    // numElements starting at absolute index `start`
+    Spans getSpans(int start, int numElements) noexcept
+    {
+        jassert(numElements <= length);
+
+        Spans spans;
+        const int first = start & mask;
+        spans.first = buffer.data() + first;
+        spans.firstSize = juce::jmin(numElements, length - first);
+        spans.second = buffer.data();
+        spans.secondSize = numElements - spans.firstSize;
+        return spans;
+    }
+
+    // The next numElements to be written; call advance() once they are filled
+    Spans getWriteSpans(int numElements) noexcept { return getSpans(writeIndex, numElements); }
+
+    void advance(int numElements) noexcept { writeIndex = (writeIndex + numElements) & mask; }
+
+    // Copies numElements starting at absolute index `start` into dest
+    void copyOut(int start, int numElements, T* dest) noexcept
+    {
+        const auto spans = getSpans(start, numElements);
+        std::copy(spans.first, spans.first + spans.firstSize, dest);
+        std::copy(spans.second, spans.second + spans.secondSize, dest + spans.firstSize);
+    }
+
+private:
+    std::vector<T> buffer;
+    int length = 0;
+    int mask = 0;
+    int writeIndex = 0;
+};
+
+//==============================================================================
+// The recorded side of the tape loop: a CircularBuffer of frames in one of the
+// TapeStorageFormats. Only the buffer of the chosen format is allocated. Reads
+// come back as float frames and writes take float frames, so the format is
+// invisible to the delay line apart from the conversion noise.
+template <int NumLanes>
+class TapeStore
+{
+public:
+    using Frame = TapeFrame<NumLanes>;
+
+    void setSize(TapeStorageFormat newFormat, int minimumLength)
+    {
+        format = newFormat;
+        floatFrames.setSize(format == TapeStorageFormat::float32 ? minimumLength : 0);
+        halfFrames.setSize(format == TapeStorageFormat::float16 ? minimumLength : 0);
+        int16Frames.setSize(format == TapeStorageFormat::int16 ? minimumLength : 0);
+        ditherCounter = 0;
+    }
+
+    TapeStorageFormat getFormat() const noexcept { return format; }
+
+    size_t getSizeInBytes() const noexcept
+    {
+        return static_cast<size_t>(floatFrames.getLength()) * sizeof(Frame)
+             + static_cast<size_t>(halfFrames.getLength()) * sizeof(HalfFrame)
+             + static_cast<size_t>(int16Frames.getLength()) * sizeof(Int16Frame);
+    }
+
+    void clear()
+    {
+        floatFrames.clear();
+        halfFrames.clear();
+        int16Frames.clear();
+    }
+
+    int getLength() const noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16: return halfFrames.getLength();
+            case TapeStorageFormat::int16:   return int16Frames.getLength();
+            case TapeStorageFormat::float32:
+            default:                         return floatFrames.getLength();
+        }
+    }
+
+    int getWriteIndex() const noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16: return halfFrames.getWriteIndex();
+            case TapeStorageFormat::int16:   return int16Frames.getWriteIndex();
+            case TapeStorageFormat::float32:
+            default:                         return floatFrames.getWriteIndex();
+        }
+    }
+
+    // One lane of the frame at any absolute index
+    float getWrapped(int index, int lane) const noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16: return TapeStorageConversion::halfToFloat(halfFrames.getWrapped(index)[static_cast<size_t>(lane)]);
+            case TapeStorageFormat::int16:   return TapeStorageConversion::int16ToFloat(int16Frames.getWrapped(index)[static_cast<size_t>(lane)]);
+            case TapeStorageFormat::float32:
+            default:                         return floatFrames.getWrapped(index)[lane];
+        }
+    }
+
+    // numFrames starting at absolute index `start`, converted into dest
+    void copyOut(int start, int numFrames, Frame* dest) noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16: convertOut(halfFrames.getSpans(start, numFrames), dest); break;
+            case TapeStorageFormat::int16:   convertOut(int16Frames.getSpans(start, numFrames), dest); break;
+            case TapeStorageFormat::float32:
+            default:                         floatFrames.copyOut(start, numFrames, dest); break;
+        }
+    }
+
+    void write(const Frame& frame) noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16:
+            {
+                HalfFrame stored;
+                for (int lane = 0; lane < NumLanes; ++lane)
+                    stored[static_cast<size_t>(lane)] = TapeStorageConversion::floatToHalf(frame[lane]);
+                halfFrames.write(stored);
+                break;
+            }
+            case TapeStorageFormat::int16:
+            {
+                Int16Frame stored;
+                for (int lane = 0; lane < NumLanes; ++lane)
+                    stored[static_cast<size_t>(lane)] = TapeStorageConversion::floatToInt16(frame[lane], ditherCounter++);
+                int16Frames.write(stored);
+                break;
+            }
+            case TapeStorageFormat::float32:
+            default:
+                floatFrames.write(frame);
+                break;
+        }
+    }
+
+    // Records input + delayed * feedback for the next numFrames frames, straight
+    // into the (at most two) destination spans, and returns the peak recorded
+    float record(const Frame* input, const Frame* delayed, const float* feedback, int numFrames) noexcept
+    {
+        switch (format)
+        {
+            case TapeStorageFormat::float16: return recordSpans(halfFrames, input, delayed, feedback, numFrames);
+            case TapeStorageFormat::int16:   return recordSpans(int16Frames, input, delayed, feedback, numFrames);
+            case TapeStorageFormat::float32:
+            default:                         return recordSpans(floatFrames, input, delayed, feedback, numFrames);
+        }
+    }
+
+private:
+    using HalfFrame = std::array<juce::uint16, static_cast<size_t>(NumLanes)>;
+    using Int16Frame = std::array<juce::int16, static_cast<size_t>(NumLanes)>;
+
+    template <typename Spans>
+    static void convertOut(const Spans& spans, Frame* dest) noexcept
+    {
+        // Frames are contiguous lanes, so each span converts as one flat array
+        TapeStorageConversion::toFloat(spans.first[0].data(), &dest[0][0], spans.firstSize * NumLanes);
+
+        if (spans.secondSize > 0)
+            TapeStorageConversion::toFloat(spans.second[0].data(), &dest[spans.firstSize][0], spans.secondSize * NumLanes);
+    }
+
+    template <typename Stored>
+    float recordSpans(CircularBuffer<Stored>& buffer, const Frame* input, const Frame* delayed, const float* feedback, int numFrames) noexcept
+    {
+        const auto spans = buffer.getWriteSpans(numFrames);
+        const float firstPeak = recordFrames(spans.first, input, delayed, feedback, spans.firstSize);
+        const float secondPeak = recordFrames(spans.second, input + spans.firstSize, delayed + spans.firstSize, feedback + spans.firstSize,
+            spans.secondSize);
+        buffer.advance(numFrames);
+        return juce::jmax(firstPeak, secondPeak);
+    }
+
+    static float recordFrames(Frame* dest, const Frame* input, const Frame* delayed, const float* feedback, int numFrames) noexcept
+    {
+        Frame peak;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                dest[i][lane] = input[i][lane] + delayed[i][lane] * feedback[i];
+                peak[lane] = juce::jmax(peak[lane], std::abs(dest[i][lane]));
+            }
+        }
+
+        return getPeak(peak);
+    }
+
+    static float recordFrames(HalfFrame* dest, const Frame* input, const Frame* delayed, const float* feedback, int numFrames) noexcept
+    {
+        Frame peak;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float value = input[i][lane] + delayed[i][lane] * feedback[i];
+                dest[i][static_cast<size_t>(lane)] = TapeStorageConversion::floatToHalf(value);
+                peak[lane] = juce::jmax(peak[lane], std::abs(value));
+            }
+        }
+
+        return getPeak(peak);
+    }
+
+    float recordFrames(Int16Frame* dest, const Frame* input, const Frame* delayed, const float* feedback, int numFrames) noexcept
+    {
+        Frame peak;
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float value = input[i][lane] + delayed[i][lane] * feedback[i];
+                dest[i][static_cast<size_t>(lane)] = TapeStorageConversion::floatToInt16(value,
+                    ditherCounter + static_cast<juce::uint32>(i * NumLanes + lane));
+                peak[lane] = juce::jmax(peak[lane], std::abs(value));
+            }
+        }
+
+        ditherCounter += static_cast<juce::uint32>(numFrames * NumLanes);
+        return getPeak(peak);
+    }
+
+    // Per-lane peaks are kept apart in the loops above so the lanes stay packed
+    static float getPeak(const Frame& peak) noexcept
+    {
+        float highest = 0.0f;
+        for (int lane = 0; lane < NumLanes; ++lane)
+            highest = juce::jmax(highest, peak[lane]);
+
+        return highest;
+    }
+
+    TapeStorageFormat format = TapeStorageFormat::float32;
+    CircularBuffer<Frame> floatFrames;
+    CircularBuffer<HalfFrame> halfFrames;
+    CircularBuffer<Int16Frame> int16Frames;
+    juce::uint32 ditherCounter = 0;
+};
+
+//==============================================================================
+// Fractional-delay interpolators for TapeDelayLine, chosen at compile time.
+// Each reads numPoints samples starting pointsBefore samples before the
+// integer read index, `stride` floats apart (NumLanes inside interleaved
+// frames), with fraction in [0, 1) towards the newer sample. `state` is one
+// float per lane kept by the delay line; only the allpass uses it.
+enum class InterpolationQuality
+{
+    linear,
+    hermite,
+    lagrange,
+    allpass,
+    sinc
+};
+
+struct LinearInterpolation
+{
+    static constexpr int pointsBefore = 0;
+    static constexpr int numPoints = 2;
+
+    static float interpolate(const float* points, int stride, float fraction, float&) noexcept
+    {
+        const float sample0 = points[0];
+        const float sample1 = points[stride];
+        return sample0 + fraction * (sample1 - sample0);
+    }
+};
+
+// 4-point, 3rd-order Hermite (Catmull-Rom)
+struct HermiteInterpolation
+{
+    static constexpr int pointsBefore = 1;
+    static constexpr int numPoints = 4;
+
+    static float interpolate(const float* points, int stride, float fraction, float&) noexcept
+    {
+        const float x0 = points[0], x1 = points[stride], x2 = points[2 * stride], x3 = points[3 * stride];
+
+        const float c1 = 0.5f * (x2 - x0);
+        const float c2 = x0 - 2.5f * x1 + 2.0f * x2 - 0.5f * x3;
+        const float c3 = 0.5f * (x3 - x0) + 1.5f * (x1 - x2);
+        return ((c3 * fraction + c2) * fraction + c1) * fraction + x1;
+    }
+};
+
+// 4-point, 3rd-order Lagrange
+struct LagrangeInterpolation
+{
+    static constexpr int pointsBefore = 1;
+    static constexpr int numPoints = 4;
+
+    static float interpolate(const float* points, int stride, float fraction, float&) noexcept
+    {
+        const float x0 = points[0], x1 = points[stride], x2 = points[2 * stride], x3 = points[3 * stride];
+
+        const float dm1 = fraction + 1.0f;
+        const float d1 = fraction - 1.0f;
+        const float d2 = fraction - 2.0f;
+
+        return -fraction * d1 * d2 * (1.0f / 6.0f) * x0
+             + dm1 * d1 * d2 * 0.5f * x1
+             - dm1 * fraction * d2 * 0.5f * x2
+             + dm1 * fraction * d1 * (1.0f / 6.0f) * x3;
+    }
+};
+
+// First-order (Thiran) allpass: flat magnitude, so no high-frequency loss,
+// but it has memory and smears fast delay changes. The allpass runs on the
+// delay behind its newer point, kept within [0.618, 1.618] samples by moving
+// to the next pair of points when it would drop lower (as in the Thiran mode
+// of juce::dsp::DelayLine): near a delay of 0 the pole sits next to -1 and
+// the filter rings at Nyquist. The coefficient stays within +-0.236.
+struct AllpassInterpolation
+{
+    static constexpr int pointsBefore = 0;
+    static constexpr int numPoints = 3;
+
+    static float interpolate(const float* points, int stride, float fraction, float& state) noexcept
+    {
+        const bool shifted = fraction > 0.382f;
+        const float older = shifted ? points[stride] : points[0];
+        const float newer = shifted ? points[2 * stride] : points[stride];
+        const float delay = (shifted ? 2.0f : 1.0f) - fraction;
+
+        const float alpha = (1.0f - delay) / (1.0f + delay);
+        state = older + alpha * (newer - state);
+        return state;
+    }
+};
+
+// 8-point Blackman-windowed sinc. Kernels for numPhases fractions are
+// tabulated once; in between two rows are blended linearly.
+struct SincInterpolation
+{
+    static constexpr int pointsBefore = 3;
+    static constexpr int numPoints = 8;
+    static constexpr int numPhases = 256;
+
+    using Kernel = std::array<float, numPoints>;
+
+    static float interpolate(const float* points, int stride, float fraction, float&) noexcept
+    {
+        const float position = fraction * static_cast<float>(numPhases);
+        const int phase = juce::jmin(static_cast<int>(position), numPhases - 1);
+        const float blend = position - static_cast<float>(phase);
+
+        const auto& kernel0 = kernels[static_cast<size_t>(phase)];
+        const auto& kernel1 = kernels[static_cast<size_t>(phase + 1)];
+
+        float sum = 0.0f;
+        for (int i = 0; i < numPoints; ++i)
+            sum += (kernel0[static_cast<size_t>(i)] + blend * (kernel1[static_cast<size_t>(i)] - kernel0[static_cast<size_t>(i)])) * points[i * stride];
+
+        return sum;
+    }
+
+private:
+    static std::array<Kernel, numPhases + 1> makeKernels()
+    {
+        std::array<Kernel, numPhases + 1> result{};
+        const double halfWidth = numPoints / 2.0;
+
+        for (int phase = 0; phase <= numPhases; ++phase)
+        {
+            const double fraction = static_cast<double>(phase) / numPhases;
+            double sum = 0.0;
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const double t = static_cast<double>(i - pointsBefore) - fraction;
+                const double x = juce::MathConstants<double>::pi * t;
+                const double sinc = t == 0.0 ? 1.0 : std::sin(x) / x;
+                const double window = 0.42 + 0.5 * std::cos(x / halfWidth) + 0.08 * std::cos(2.0 * x / halfWidth);
+                result[static_cast<size_t>(phase)][static_cast<size_t>(i)] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+
+            // Unity gain at DC for every fraction
+            for (auto& tap : result[static_cast<size_t>(phase)])
+                tap = static_cast<float>(tap / sum);
+        }
+
+        return result;
+    }
+
+    // Built during static initialisation, never on the audio thread
+    static inline const std::array<Kernel, numPhases + 1> kernels = makeKernels();
+};
+
+//==============================================================================
+// In FilterMode parameter order: the 1-pole LaneLowPassFilter or one response
+// of the state-variable filter below
+enum class FilterMode
+{
+    onePole,
+    lowPass,
+    bandPass,
+    highPass
+};
+
+// Topology-preserving (trapezoidal) state-variable filter on every lane of a
+// TapeFrame, after Zavalishin / Simper. Each stage computes the low-pass,
+// band-pass and high-pass outputs together and the mode only picks the mix,
+// so the lane loop has no branches. The TPT structure stays stable while the
+// cutoff moves, so no output checks are needed. Up to MaxStages stages can be
+// cascaded (12 dB/oct each). The cutoff is handled like LaneLowPassFilter: a
+// ramp, sampled every coefficientInterval samples.
+template <int NumLanes, int MaxStages = 2>
+class LaneStateVariableFilter
+{
+public:
+    using Frame = TapeFrame<NumLanes>;
+
+    static constexpr int coefficientInterval = 16;
+
+    void prepare(double sampleRate)
+    {
+        sr = static_cast<float>(sampleRate);
+        reset();
+    }
+
+    // Clears the state; the next sample picks up new coefficients
+    void reset()
+    {
+        ic1eq = {};
+        ic2eq = {};
+        samplesUntilUpdate = 0;
+    }
+
+    // cutoff holds numSamples values in Hz, scaled by cutoffScale. resonance
+    // runs from 0 (Butterworth at either slope) to 1 (a gain of 10, +20 dB, at
+    // the cutoff). A cascade spreads it over the Butterworth pole pairs,
+    // scaled so the stage Qs multiply to the single-stage Q, so 24 dB/oct
+    // peaks no higher than 12 dB/oct. The band-pass is scaled to unity gain
+    // at the centre whatever the Q.
+    void process(const Frame* input, Frame* output, int numSamples, const float* cutoff, float cutoffScale,
+        FilterMode mode, float resonance, int numStages) noexcept
+    {
+        jassert(mode != FilterMode::onePole);
+        numStages = juce::jlimit(1, MaxStages, numStages);
+
+        // Stages switched off start again from silence
+        for (size_t stage = static_cast<size_t>(numStages); stage < maxStages; ++stage)
+        {
+            ic1eq[stage] = {};
+            ic2eq[stage] = {};
+        }
+
+        if (resonance != currentResonance || numStages != currentStages)
+            setDamping(resonance, numStages);
+
+        const float lowMix = mode == FilterMode::lowPass ? 1.0f : 0.0f;
+        const float bandMix = mode == FilterMode::bandPass ? 1.0f : 0.0f;
+        const float highMix = mode == FilterMode::highPass ? 1.0f : 0.0f;
+
+        for (int start = 0; start < numSamples;)
+        {
+            if (samplesUntilUpdate == 0)
+            {
+                setCoefficients(cutoff[start] * cutoffScale, numStages);
+                samplesUntilUpdate = coefficientInterval;
+            }
+
+            const int end = juce::jmin(numSamples, start + samplesUntilUpdate);
+            for (int sample = start; sample < end; ++sample)
+            {
+                Frame x = input[sample];
+
+                for (size_t stage = 0; stage < static_cast<size_t>(numStages); ++stage)
+                {
+                    auto& s1 = ic1eq[stage];
+                    auto& s2 = ic2eq[stage];
+                    const float k = stageK[stage];
+                    const float a1 = stageA1[stage];
+                    const float a2 = stageA2[stage];
+                    const float a3 = stageA3[stage];
+                    const float bandGain = bandMix * k;
+
+                    for (int lane = 0; lane < NumLanes; ++lane)
+                    {
+                        const float v3 = x[lane] - s2[lane];
+                        const float v1 = a1 * s1[lane] + a2 * v3;
+                        const float v2 = s2[lane] + a2 * s1[lane] + a3 * v3;
+                        s1[lane] = 2.0f * v1 - s1[lane];
+                        s2[lane] = 2.0f * v2 - s2[lane];
+
+                        const float high = x[lane] - k * v1 - v2;
+                        x[lane] = lowMix * v2 + bandGain * v1 + highMix * high;
+                    }
+                }
+
+                output[sample] = x;
+            }
+
+            samplesUntilUpdate -= end - start;
+            start = end;
+        }
+    }
+
+    // Highest gain at any frequency, for loop-gain limiting: 1 for the
+    // band-pass, and for the low-pass and high-pass the product of the stage
+    // peaks (each Q / sqrt(1 - 1 / 4Q^2), 1 up to Q 0.707), an upper bound on
+    // the cascade's peak
+    static float getPeakGain(FilterMode mode, float resonance, int numStages) noexcept
+    {
+        if (mode == FilterMode::onePole || mode == FilterMode::bandPass)
+            return 1.0f;
+
+        numStages = juce::jlimit(1, MaxStages, numStages);
+        float peak = 1.0f;
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            const float q = getStageQ(resonance, stage, numStages);
+            if (q > 0.5f * juce::MathConstants<float>::sqrt2)
+                peak *= q / std::sqrt(1.0f - 0.25f / (q * q));
+        }
+
+        return peak;
+    }
+
+private:
+    static constexpr float maxQ = 10.0f;
+
+    // Q of every stage, see process()
+    static float getStageQ(float resonance, int stage, int numStages) noexcept
+    {
+        const float scale = std::pow(maxQ * juce::MathConstants<float>::sqrt2, resonance / static_cast<float>(numStages));
+        const float angle = juce::MathConstants<float>::pi * static_cast<float>(2 * stage + 1) / static_cast<float>(4 * numStages);
+        return 0.5f / std::sin(angle) * scale;
+    }
+
+    // Damping (1 / Q) of every stage: the Butterworth Qs of the whole cascade,
+    // each raised by the same factor. It takes effect at the next coefficient
+    // update, with the cutoff.
+    void setDamping(float resonance, int numStages) noexcept
+    {
+        for (int stage = 0; stage < numStages; ++stage)
+            damping[static_cast<size_t>(stage)] = 1.0f / getStageQ(resonance, stage, numStages);
+
+        currentResonance = resonance;
+        currentStages = numStages;
+    }
+
+    void setCoefficients(float freq, int numStages) noexcept
+    {
+        // Kept clear of Nyquist, where the prewarped gain goes to infinity
+        freq = juce::jlimit(20.0f, juce::jmin(20000.0f, 0.45f * sr), freq);
+        const float g = std::tan(juce::MathConstants<float>::pi * freq / sr);
+
+        for (size_t stage = 0; stage < static_cast<size_t>(numStages); ++stage)
+        {
+            stageK[stage] = damping[stage];
+            stageA1[stage] = 1.0f / (1.0f + g * (g + stageK[stage]));
+            stageA2[stage] = g * stageA1[stage];
+            stageA3[stage] = g * stageA2[stage];
+        }
+    }
+
+    float sr = 44100.0f;
+    float currentResonance = -1.0f;
+    int currentStages = 0;
+    static constexpr size_t maxStages = static_cast<size_t>(MaxStages);
+
+    std::array<float, maxStages> damping{};
+    std::array<float, maxStages> stageK{};
+    std::array<float, maxStages> stageA1{};
+    std::array<float, maxStages> stageA2{};
+    std::array<float, maxStages> stageA3{};
+    std::array<Frame, maxStages> ic1eq;
+    std::array<Frame, maxStages> ic2eq;
+    int samplesUntilUpdate = 0;
+};
+
+//==============================================================================
+// Playback heads reading one TapeDelayLine, Space Echo style. Each head sits at
+// a fraction of the loop delay, reaches the output with its own per-lane gain
+// (level and pan) and sends its own share of the signal into the feedback path.
+template <int NumLanes, int MaxHeads>
+struct TapeHeadLayout
+{
+    using Frame = TapeFrame<NumLanes>;
+
+    TapeHeadLayout()
+    {
+        delayRatio.fill(1.0f);
+        feedbackSend.fill(1.0f);
+
+        for (auto& gain : outputGain)
+            for (int lane = 0; lane < NumLanes; ++lane)
+                gain[lane] = 1.0f;
+    }
+
+    // What the heads feed back at most, all in phase
+    float getFeedbackSendSum() const noexcept
+    {
+        float sum = 0.0f;
+        for (int head = 0; head < numHeads; ++head)
+            sum += feedbackSend[static_cast<size_t>(head)];
+
+        return sum;
+    }
+
+    // One head at the loop delay, going unscaled to the output and the
+    // feedback path: the plain single-head tape loop
+    bool isSingleUnityHead() const noexcept
+    {
+        if (numHeads != 1 || delayRatio[0] != 1.0f || feedbackSend[0] != 1.0f)
+            return false;
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+            if (outputGain[0][lane] != 1.0f)
+                return false;
+
+        return true;
+    }
+
+    int numHeads = 1;
+    std::array<float, static_cast<size_t>(MaxHeads)> delayRatio;
+    std::array<Frame, static_cast<size_t>(MaxHeads)> outputGain;
+    std::array<float, static_cast<size_t>(MaxHeads)> feedbackSend;
+};
+
+//==============================================================================
+// Tape loop shared by NumLanes channels. Frames are stored interleaved in a
+// masked circular buffer so a write touches one contiguous frame, and every
+// step below runs on all lanes at once.
+// Up to MaxHeads playback heads can read the same loop (see TapeHeadLayout);
+// the overloads without a layout use a single head.
+template <int NumLanes, int MaxHeads = 1>
+class TapeDelayLine
+{
+public:
+    using Frame = TapeFrame<NumLanes>;
+    using Heads = TapeHeadLayout<NumLanes, MaxHeads>;
+
+    TapeDelayLine() = default;
+    ~TapeDelayLine() = default;
+
+    void prepare(int maximumDelaySamples, int maximumBlockSize, TapeStorageFormat storageFormat = TapeStorageFormat::float32)
+    {
+        maxDelay = maximumDelaySamples;
+        maxBlockSize = maximumBlockSize;
+        frames.setSize(storageFormat, maximumDelaySamples + maxInterpolationPoints);
+
+        // Per head: room for a block plus a ramp of up to one block on top
+        headScratchSize = 2 * maximumBlockSize + 2 * maxInterpolationPoints;
+        readScratch.assign(static_cast<size_t>(MaxHeads * headScratchSize), Frame{});
+
+        // Head reads for the multi-head and crossfade forms
+        headOutputs.assign(static_cast<size_t>(MaxHeads * maximumBlockSize), Frame{});
+        fadeOutputs.assign(static_cast<size_t>(MaxHeads * maximumBlockSize), Frame{});
+        feedbackFrames.assign(static_cast<size_t>(maximumBlockSize), Frame{});
+    }
+
+    // Rate the loop runs at, for the filters in the feedback path
+    void setSampleRate(double sampleRate)
+    {
+        dcCoefficient = static_cast<float>(std::exp(-2.0 * juce::MathConstants<double>::pi * dcBlockerCutoff / sampleRate));
+        loopFilter.prepare(sampleRate);
+    }
+
+    // Resonant filter in the feedback path, after the DC blocker, so every
+    // pass round the loop is filtered again. FilterMode::onePole leaves the
+    // loop unfiltered. cutoff holds a value in Hz for every sample processed
+    // until the next call, scaled by cutoffScale.
+    void setLoopFilter(FilterMode mode, float resonance, int numStages, const float* cutoff, float cutoffScale) noexcept
+    {
+        // A filter switched off starts again from silence
+        if (mode == FilterMode::onePole)
+            loopFilter.reset();
+
+        loopFilterMode = mode;
+        loopFilterResonance = resonance;
+        loopFilterStages = numStages;
+        loopFilterCutoff = cutoff;
+        loopFilterCutoffScale = cutoffScale;
+        loopFilterPosition = 0;
+    }
+
+    int getMaximumDelayInSamples() const { return maxDelay; }
+
+    // Peak of everything recorded onto the tape since the last call, so
+    // callers can tell when the loop holds only silence
+    float takeRecordedPeak() noexcept
+    {
+        const float peak = recordedPeak;
+        recordedPeak = 0.0f;
+        return peak;
+    }
+    TapeStorageFormat getStorageFormat() const { return frames.getFormat(); }
+
+    // Memory held by the recorded loop
+    size_t getStorageSizeInBytes() const { return frames.getSizeInBytes(); }
+
+    // Lowers the delay clamp without reallocating, e.g. when the loop runs at a
+    // lower rate than the one it was prepared for
+    void setMaximumDelay(int maximumDelaySamples)
+    {
+        jassert(maximumDelaySamples + maxInterpolationPoints <= frames.getLength());
+        maxDelay = maximumDelaySamples;
+    }
+
+    // Interpolator is one of the interpolation policies above and Saturator
+    // one of the saturation policies below, both picked once per block so the
+    // whole per-sample chain can be inlined
+    template <typename Interpolator, typename Saturator>
+    Frame process(const Frame& input, const Frame& delayInSamples, float feedback, const Saturator& saturate)
+    {
+        Frame delayed = read<Interpolator>(delayInSamples, interpolatorState[0]);
+        for (int lane = 0; lane < NumLanes; ++lane)
+            delayed[lane] = saturate(delayed[lane]);
+
+        const Frame fedBack = conditionFeedback(delayed);
+        record(input, fedBack, feedback);
+        return delayed;
+    }
+
+    // A block with a delay for every sample: delays[sample] is the delay that
+    // sample reads at. When every delay is at least one block long, nothing
+    // read here was written here, so the frames needed are copied out in one
+    // go, processed, and written back as whole spans. Shorter delays or steep
+    // ramps fall back to process().
+    template <typename Interpolator, typename Saturator>
+    void processBlock(const Frame* input, Frame* output, int numSamples,
+        const Frame* delays, const float* feedback, const Saturator& saturate)
+    {
+        jassert(numSamples <= maxBlockSize);
+
+        const int writeIndex = frames.getWriteIndex();
+        const float minimumDelay = getMinimumDelay<Interpolator>();
+
+        Frame shortest, longest;
+        findDelayRange(delays, numSamples, shortest, longest);
+
+        int firstFrame, numFramesNeeded;
+        if (!planRead<Interpolator>(shortest, longest, numSamples, 1.0f, firstFrame, numFramesNeeded))
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] = process<Interpolator>(input[sample], delays[sample], feedback[sample], saturate);
+            return;
+        }
+
+        // Read: one or two contiguous copies, then interpolate without wrapping
+        frames.copyOut(firstFrame, numFramesNeeded, readScratch.data());
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float delay = juce::jlimit(minimumDelay, static_cast<float>(maxDelay), delays[sample][lane]);
+                int index0;
+                float fraction;
+                splitReadPosition(writeIndex + sample - firstFrame, delay, index0, fraction);
+
+                // Points of one lane are NumLanes floats apart in the scratch frames
+                const float* points = &readScratch[static_cast<size_t>(index0 - Interpolator::pointsBefore)][lane];
+                output[sample][lane] = Interpolator::interpolate(points, NumLanes, fraction, interpolatorState[0][lane]);
+            }
+        }
+
+        // Frames are contiguous lanes, so the whole block saturates as one array
+        saturate.process(&output[0][0], numSamples * NumLanes);
+
+        // Write: fill the (at most two) destination spans directly
+        conditionFeedback(output, feedbackFrames.data(), numSamples);
+        recordedPeak = juce::jmax(recordedPeak, frames.record(input, feedbackFrames.data(), feedback, numSamples));
+    }
+
+    //==============================================================================
+    // Multi-head forms: the returned / output frame is the heads mixed with
+    // their output gains, and the tape records the input plus feedback times
+    // the heads mixed with their feedback sends. delayInSamples is the loop
+    // delay; each head reads at its delayRatio of it.
+    template <typename Interpolator, typename Saturator>
+    Frame process(const Frame& input, const Frame& delayInSamples, float feedback, const Saturator& saturate, const Heads& heads)
+    {
+        if (heads.isSingleUnityHead())
+            return process<Interpolator>(input, delayInSamples, feedback, saturate);
+
+        jassert(heads.numHeads >= 1 && heads.numHeads <= MaxHeads);
+
+        Frame mixed, fedBack;
+        for (int head = 0; head < heads.numHeads; ++head)
+        {
+            const auto index = static_cast<size_t>(head);
+            Frame headDelay;
+            for (int lane = 0; lane < NumLanes; ++lane)
+                headDelay[lane] = delayInSamples[lane] * heads.delayRatio[index];
+
+            const Frame delayed = read<Interpolator>(headDelay, interpolatorState[index]);
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float saturated = saturate(delayed[lane]);
+                mixed[lane] += saturated * heads.outputGain[index][lane];
+                fedBack[lane] += saturated * heads.feedbackSend[index];
+            }
+        }
+
+        fedBack = conditionFeedback(fedBack);
+        record(input, fedBack, feedback);
+        return mixed;
+    }
+
+    // Every head copies out its own window of the loop; all heads are then
+    // interpolated, saturated and mixed in one pass over the block before the
+    // block is written back as whole spans
+    template <typename Interpolator, typename Saturator>
+    void processBlock(const Frame* input, Frame* output, int numSamples,
+        const Frame* delays, const float* feedback, const Saturator& saturate, const Heads& heads)
+    {
+        if (heads.isSingleUnityHead())
+        {
+            processBlock<Interpolator>(input, output, numSamples, delays, feedback, saturate);
+            return;
+        }
+
+        jassert(numSamples <= maxBlockSize);
+        jassert(heads.numHeads >= 1 && heads.numHeads <= MaxHeads);
+
+        HeadReads reads;
+        if (!planHeadReads<Interpolator>(reads, numSamples, delays, heads))
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] = process<Interpolator>(input[sample], delays[sample], feedback[sample], saturate, heads);
+            return;
+        }
+
+        readHeads<Interpolator>(reads, numSamples, saturate, heads, headOutputs.data(), interpolatorState.data());
+        mixAndRecord(input, output, numSamples, feedback, heads);
+    }
+
+    //==============================================================================
+    // Crossfade forms: every head reads the loop twice, at the outgoing delay
+    // (fromDelay) and at the incoming one, and fade is the incoming share (0 to
+    // 1). Moving the read heads this way jumps to a new delay without the pitch
+    // sweep of ramping the delay time. Call beginCrossfade() when a fade starts
+    // so the outgoing reads carry on from the current interpolator state.
+    void beginCrossfade() noexcept
+    {
+        fadeInterpolatorState = interpolatorState;
+    }
+
+    template <typename Interpolator, typename Saturator>
+    Frame process(const Frame& input, const Frame& fromDelay, const Frame& delayInSamples, float fade, float feedback,
+        const Saturator& saturate, const Heads& heads)
+    {
+        jassert(heads.numHeads >= 1 && heads.numHeads <= MaxHeads);
+
+        Frame mixed, fedBack;
+        for (int head = 0; head < heads.numHeads; ++head)
+        {
+            const auto index = static_cast<size_t>(head);
+            Frame outgoingDelay, incomingDelay;
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                outgoingDelay[lane] = fromDelay[lane] * heads.delayRatio[index];
+                incomingDelay[lane] = delayInSamples[lane] * heads.delayRatio[index];
+            }
+
+            const Frame outgoing = read<Interpolator>(outgoingDelay, fadeInterpolatorState[index]);
+            const Frame incoming = read<Interpolator>(incomingDelay, interpolatorState[index]);
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float from = saturate(outgoing[lane]);
+                const float saturated = from + (saturate(incoming[lane]) - from) * fade;
+                mixed[lane] += saturated * heads.outputGain[index][lane];
+                fedBack[lane] += saturated * heads.feedbackSend[index];
+            }
+        }
+
+        fedBack = conditionFeedback(fedBack);
+        record(input, fedBack, feedback);
+        return mixed;
+    }
+
+    // Both sets of reads go through the span path of the multi-head block, so
+    // a crossfade costs one extra read pass and a blend
+    template <typename Interpolator, typename Saturator>
+    void processBlock(const Frame* input, Frame* output, int numSamples, const Frame* fromDelays, const Frame* delays,
+        const float* fade, const float* feedback, const Saturator& saturate, const Heads& heads)
+    {
+        jassert(numSamples <= maxBlockSize);
+        jassert(heads.numHeads >= 1 && heads.numHeads <= MaxHeads);
+
+        HeadReads outgoing, incoming;
+        if (!planHeadReads<Interpolator>(outgoing, numSamples, fromDelays, heads)
+            || !planHeadReads<Interpolator>(incoming, numSamples, delays, heads))
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+                output[sample] = process<Interpolator>(input[sample], fromDelays[sample], delays[sample], fade[sample], feedback[sample],
+                    saturate, heads);
+            return;
+        }
+
+        readHeads<Interpolator>(outgoing, numSamples, saturate, heads, fadeOutputs.data(), fadeInterpolatorState.data());
+        readHeads<Interpolator>(incoming, numSamples, saturate, heads, headOutputs.data(), interpolatorState.data());
+
+        for (int head = 0; head < heads.numHeads; ++head)
+        {
+            const Frame* from = fadeOutputs.data() + head * maxBlockSize;
+            Frame* headOutput = headOutputs.data() + head * maxBlockSize;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+                for (int lane = 0; lane < NumLanes; ++lane)
+                    headOutput[sample][lane] = from[sample][lane] + (headOutput[sample][lane] - from[sample][lane]) * fade[sample];
+        }
+
+        mixAndRecord(input, output, numSamples, feedback, heads);
+    }
+
+    void reset()
+    {
+        frames.clear();
+        interpolatorState = {};
+        fadeInterpolatorState = {};
+        dcInput = {};
+        dcOutput = {};
+        loopFilter.reset();
+        recordedPeak = 0.0f;
+    }
+
+private:
+    // Widest interpolator (SincInterpolation) plus a spare frame
+    static constexpr int maxInterpolationPoints = 9;
+
+    static constexpr double dcBlockerCutoff = 20.0; // Hz
+
+    // The newest point read must already be on the tape
+    template <typename Interpolator>
+    static float getMinimumDelay() noexcept
+    {
+        return static_cast<float>(juce::jmax(1, Interpolator::numPoints - Interpolator::pointsBefore - 1));
+    }
+
+    // Where every head reads over one block: the loop delays (each head reads
+    // at its delayRatio of them) and the window of the loop that covers them
+    struct HeadReads
+    {
+        const Frame* delays = nullptr;
+        std::array<int, static_cast<size_t>(MaxHeads)> firstFrame, numFrames;
+    };
+
+    // Shortest and longest delay of every lane over a block
+    static void findDelayRange(const Frame* delays, int numSamples, Frame& shortest, Frame& longest) noexcept
+    {
+        shortest = delays[0];
+        longest = delays[0];
+        for (int sample = 1; sample < numSamples; ++sample)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                shortest[lane] = juce::jmin(shortest[lane], delays[sample][lane]);
+                longest[lane] = juce::jmax(longest[lane], delays[sample][lane]);
+            }
+        }
+    }
+
+    // The window of the loop read over one block at ratio times delays in the
+    // given range. It covers every read from the first sample at the longest
+    // delay to the last at the shortest, so it is at most a block longer than
+    // needed. False when it cannot be read from spans: a delay shorter than
+    // the block, or a window larger than a scratch slice.
+    template <typename Interpolator>
+    bool planRead(const Frame& shortest, const Frame& longest, int numSamples, float ratio, int& firstFrame, int& numFrames) const noexcept
+    {
+        constexpr int pointsAfter = Interpolator::numPoints - Interpolator::pointsBefore - 1;
+        const float minimumDelay = getMinimumDelay<Interpolator>();
+
+        float lowestDelay = std::numeric_limits<float>::max();
+        float highestDelay = std::numeric_limits<float>::lowest();
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            lowestDelay = juce::jmin(lowestDelay, juce::jlimit(minimumDelay, static_cast<float>(maxDelay), shortest[lane] * ratio));
+            highestDelay = juce::jmax(highestDelay, juce::jlimit(minimumDelay, static_cast<float>(maxDelay), longest[lane] * ratio));
+        }
+
+        // Read positions relative to the write index, plus the interpolator's
+        // points and one spare frame on each side to absorb rounding
+        const int writeIndex = frames.getWriteIndex();
+        firstFrame = writeIndex + static_cast<int>(std::floor(-highestDelay)) - 1 - Interpolator::pointsBefore;
+        numFrames = writeIndex + static_cast<int>(std::floor(static_cast<float>(numSamples - 1) - lowestDelay)) - firstFrame + 2 + pointsAfter;
+
+        return lowestDelay >= static_cast<float>(numSamples + pointsAfter) && numFrames <= headScratchSize;
+    }
+
+    template <typename Interpolator>
+    bool planHeadReads(HeadReads& reads, int numSamples, const Frame* delays, const Heads& heads) const
+    {
+        Frame shortest, longest;
+        findDelayRange(delays, numSamples, shortest, longest);
+
+        reads.delays = delays;
+        bool canUseSpans = true;
+
+        for (size_t head = 0; head < static_cast<size_t>(heads.numHeads); ++head)
+            canUseSpans = planRead<Interpolator>(shortest, longest, numSamples, heads.delayRatio[head],
+                reads.firstFrame[head], reads.numFrames[head]) && canUseSpans;
+
+        return canUseSpans;
+    }
+
+    // Copies out, interpolates and saturates every head into its slice of
+    // outputs (maxBlockSize frames per head), advancing states[head]
+    template <typename Interpolator, typename Saturator>
+    void readHeads(const HeadReads& reads, int numSamples, const Saturator& saturate, const Heads& heads, Frame* outputs, Frame* states)
+    {
+        const int writeIndex = frames.getWriteIndex();
+        const float minimumDelay = getMinimumDelay<Interpolator>();
+
+        for (int head = 0; head < heads.numHeads; ++head)
+        {
+            const auto index = static_cast<size_t>(head);
+            const float ratio = heads.delayRatio[index];
+            const int firstFrame = reads.firstFrame[index];
+            Frame* scratch = readScratch.data() + head * headScratchSize;
+            Frame* headOutput = outputs + head * maxBlockSize;
+            frames.copyOut(firstFrame, reads.numFrames[index], scratch);
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    const float delay = juce::jlimit(minimumDelay, static_cast<float>(maxDelay), reads.delays[sample][lane] * ratio);
+                    int index0;
+                    float fraction;
+                    splitReadPosition(writeIndex + sample - firstFrame, delay, index0, fraction);
+
+                    const float* points = &scratch[index0 - Interpolator::pointsBefore][lane];
+                    headOutput[sample][lane] = Interpolator::interpolate(points, NumLanes, fraction, states[head][lane]);
+                }
+            }
+
+            saturate.process(&headOutput[0][0], numSamples * NumLanes);
+        }
+    }
+
+    // Mixes the heads in headOutputs to the output and to the feedback path,
+    // then writes the block back as whole spans
+    void mixAndRecord(const Frame* input, Frame* output, int numSamples, const float* feedback, const Heads& heads)
+    {
+        std::fill(output, output + numSamples, Frame{});
+        std::fill(feedbackFrames.begin(), feedbackFrames.begin() + numSamples, Frame{});
+
+        for (int head = 0; head < heads.numHeads; ++head)
+        {
+            const Frame* headOutput = headOutputs.data() + head * maxBlockSize;
+            const Frame gain = heads.outputGain[static_cast<size_t>(head)];
+            const float send = heads.feedbackSend[static_cast<size_t>(head)];
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    output[sample][lane] += headOutput[sample][lane] * gain[lane];
+                    feedbackFrames[static_cast<size_t>(sample)][lane] += headOutput[sample][lane] * send;
+                }
+            }
+        }
+
+        conditionFeedback(feedbackFrames.data(), feedbackFrames.data(), numSamples);
+        recordedPeak = juce::jmax(recordedPeak, frames.record(input, feedbackFrames.data(), feedback, numSamples));
+    }
+
+    // The feedback path's 1-pole high-pass: DC and sub-bass from the
+    // asymmetric saturation never build up on the tape. The heard output is
+    // not filtered.
+    Frame blockDC(const Frame& x) noexcept
+    {
+        Frame y;
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            y[lane] = x[lane] - dcInput[lane] + dcCoefficient * dcOutput[lane];
+            dcInput[lane] = x[lane];
+            dcOutput[lane] = y[lane];
+        }
+
+        return y;
+    }
+
+    // Block form; the state stays in locals so the recursion does not go
+    // through memory (output may alias input)
+    void blockDC(const Frame* input, Frame* output, int numSamples) noexcept
+    {
+        Frame x1 = dcInput, y1 = dcOutput;
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            for (int lane = 0; lane < NumLanes; ++lane)
+            {
+                const float x = input[sample][lane];
+                y1[lane] = x - x1[lane] + dcCoefficient * y1[lane];
+                x1[lane] = x;
+                output[sample][lane] = y1[lane];
+            }
+        }
+
+        dcInput = x1;
+        dcOutput = y1;
+    }
+
+    void record(const Frame& input, const Frame& fedBack, float feedback) noexcept
+    {
+        Frame written;
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            written[lane] = input[lane] + fedBack[lane] * feedback;
+            recordedPeak = juce::jmax(recordedPeak, std::abs(written[lane]));
+        }
+
+        frames.write(written);
+    }
+
+    // Everything the feedback path applies before recording: the DC blocker,
+    // then the loop filter when one is set
+    Frame conditionFeedback(const Frame& x) noexcept
+    {
+        Frame y = blockDC(x);
+        if (loopFilterMode != FilterMode::onePole)
+            filterLoop(&y, &y, 1);
+
+        return y;
+    }
+
+    void conditionFeedback(const Frame* input, Frame* output, int numSamples) noexcept
+    {
+        blockDC(input, output, numSamples);
+        if (loopFilterMode != FilterMode::onePole)
+            filterLoop(output, output, numSamples);
+    }
+
+    void filterLoop(const Frame* input, Frame* output, int numSamples) noexcept
+    {
+        jassert(loopFilterCutoff != nullptr);
+        loopFilter.process(input, output, numSamples, loopFilterCutoff + loopFilterPosition, loopFilterCutoffScale,
+            loopFilterMode, loopFilterResonance, loopFilterStages);
+        loopFilterPosition += numSamples;
+    }
+
+    // The read point delay (>= 0) samples behind position, as the index of
+    // the older interpolation point and the fraction towards the newer one.
+    // Only the fractional part of the delay goes through float arithmetic,
+    // so the fraction keeps its precision however far the write index (up to
+    // 2^20 frames) has run. The carry is 1 only for a whole-sample delay.
+    static void splitReadPosition(int position, float delay, int& index0, float& fraction) noexcept
+    {
+        const int wholeSamples = static_cast<int>(delay);
+        const float readFraction = 1.0f - (delay - static_cast<float>(wholeSamples));
+        const int carry = static_cast<int>(readFraction);
+
+        index0 = position - wholeSamples - 1 + carry;
+        fraction = readFraction - static_cast<float>(carry);
+    }
+
+    // One interpolated (unsaturated) frame at delayInSamples, with wrapping
+    template <typename Interpolator>
+    Frame read(const Frame& delayInSamples, Frame& state) const noexcept
+    {
+        Frame delayed;
+        const int writeIndex = frames.getWriteIndex();
+        const float minimumDelay = getMinimumDelay<Interpolator>();
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            const float delay = juce::jlimit(minimumDelay, static_cast<float>(maxDelay), delayInSamples[lane]);
+            int index0;
+            float fraction;
+            splitReadPosition(writeIndex, delay, index0, fraction);
+
+            float points[Interpolator::numPoints];
+            for (int i = 0; i < Interpolator::numPoints; ++i)
+                points[i] = frames.getWrapped(index0 - Interpolator::pointsBefore + i, lane);
+
+            delayed[lane] = Interpolator::interpolate(points, 1, fraction, state[lane]);
+        }
+
+        return delayed;
+    }
+
+    TapeStore<NumLanes> frames;
+    std::vector<Frame> readScratch;
+    std::vector<Frame> headOutputs;
+    std::vector<Frame> fadeOutputs;
+    std::vector<Frame> feedbackFrames;
+    std::array<Frame, static_cast<size_t>(MaxHeads)> interpolatorState;
+    std::array<Frame, static_cast<size_t>(MaxHeads)> fadeInterpolatorState;
+    Frame dcInput, dcOutput;
+    float dcCoefficient = 0.9972f; // 20 Hz at 44.1 kHz until setSampleRate
+    LaneStateVariableFilter<NumLanes> loopFilter;
+    FilterMode loopFilterMode = FilterMode::onePole;
+    float loopFilterResonance = 0.0f;
+    int loopFilterStages = 1;
+    const float* loopFilterCutoff = nullptr;
+    float loopFilterCutoffScale = 1.0f;
+    int loopFilterPosition = 0;
+    float recordedPeak = 0.0f;
+    int headScratchSize = 0;
+    int maxDelay = 0;
+    int maxBlockSize = 0;
+};
+
+//==============================================================================
+// Tape saturation
+struct TapeSaturation
+{
+    static float softClip(float x)
+    {
+        if (x > 0.0f)
+            return 1.0f - std::exp(-x);
+        else
+            return -1.0f + std::exp(x);
+    }
+
+    static float tubeWarmth(float x, float drive = 0.7f)
+    {
+        float sign = x < 0.0f ? -1.0f : 1.0f;
+        return sign * (1.0f - std::exp(-std::abs(x) * (1.0f + drive)));
+    }
+};
+
+// Saturation policies for TapeDelayLine. operator() is the per-sample form,
+// process() the in-place block form; Accuracy picks the SaturationKernels mode
+// (exact matches TapeSaturation above).
+template <SaturationAccuracy Accuracy = SaturationAccuracy::exact>
+struct SoftClipSaturator
+{
+    float drive = 1.0f;
+
+    float operator()(float x) const { return SaturationKernels::softClip<Accuracy>(x * drive); }
+    void process(float* data, int numSamples) const { SaturationKernels::softClip<Accuracy>(data, numSamples, drive); }
+};
+
+template <SaturationAccuracy Accuracy = SaturationAccuracy::exact>
+struct TubeWarmthSaturator
+{
+    float drive = 0.7f;
+
+    float operator()(float x) const { return SaturationKernels::tubeWarmth<Accuracy>(x, drive); }
+    void process(float* data, int numSamples) const { SaturationKernels::tubeWarmth<Accuracy>(data, numSamples, drive); }
+};
+
+//==============================================================================
+// The same 1-pole low-pass run on every lane of a TapeFrame. The cutoff comes
+// in per sample (a smoother ramp) and the coefficient is recomputed every
+// coefficientInterval samples with the fast exp. The interval is counted
+// across blocks, so automation sounds the same at every block size.
+template <int NumLanes>
+class LaneLowPassFilter
+{
+public:
+    using Frame = TapeFrame<NumLanes>;
+
+    static constexpr int coefficientInterval = 16;
+
+    void prepare(double sampleRate)
+    {
+        sr = static_cast<float>(sampleRate);
+        reset();
+    }
+
+    // Clears the state; the next sample picks up a new coefficient
+    void reset()
+    {
+        z1 = {};
+        samplesUntilUpdate = 0;
+    }
+
+    // cutoff holds numSamples values in Hz, scaled by cutoffScale
+    void process(const Frame* input, Frame* output, int numSamples, const float* cutoff, float cutoffScale) noexcept
+    {
+        for (int start = 0; start < numSamples;)
+        {
+            if (samplesUntilUpdate == 0)
+            {
+                setCoefficients(cutoff[start] * cutoffScale);
+                samplesUntilUpdate = coefficientInterval;
+            }
+
+            const int end = juce::jmin(numSamples, start + samplesUntilUpdate);
+            for (int sample = start; sample < end; ++sample)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                    z1[lane] = b * input[sample][lane] + a * z1[lane];
+
+                output[sample] = z1;
+            }
+
+            samplesUntilUpdate -= end - start;
+            start = end;
+        }
+    }
+
+private:
+    void setCoefficients(float freq) noexcept
+    {
+        freq = juce::jlimit(20.0f, 20000.0f, freq);
+        const float omega = 2.0f * juce::MathConstants<float>::pi * freq / sr;
+        a = SaturationKernels::fastExpNegative(omega);
+        b = 1.0f - a;
+    }
+
+    float sr = 44100.0f;
+    float a = 0.0f;
+    float b = 1.0f;
+    Frame z1;
+    int samplesUntilUpdate = 0;
+};
+
+//==============================================================================
+// Sine LFOs for every lane, rendered a block at a time from one shared table.
+// The phase runs on across blocks; each lane can be offset from the first.
+template <int NumLanes>
+class LFOBank
+{
+public:
+    static constexpr int tableSize = 2048;
+
+    void prepare(double sampleRate)
+    {
+        sr = sampleRate;
+        getSineTable();
+        updateIncrement();
+    }
+
+    // Back to the start of the cycle (plus each lane's offset)
+    void reset()
+    {
+        phase = 0.0;
+    }
+
+    void setFrequency(float newFrequency)
+    {
+        if (newFrequency != frequency)
+        {
+            frequency = newFrequency;
+            updateIncrement();
+        }
+    }
+
+    // Offset in cycles (0.25 = 90 degrees) relative to the shared phase
+    void setPhaseOffset(int lane, float offsetInCycles)
+    {
+        offsets[static_cast<size_t>(lane)] = offsetInCycles - std::floor(offsetInCycles);
+    }
+
+    // Writes numSamples of every lane and advances the shared phase
+    void process(float* const* outputs, int numSamples) noexcept
+    {
+        const auto& table = getSineTable();
+
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            double lanePhase = phase + offsets[static_cast<size_t>(lane)];
+            lanePhase -= lanePhase >= 1.0 ? 1.0 : 0.0;
+
+            auto* output = outputs[lane];
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const float position = static_cast<float>(lanePhase * tableSize);
+                const int index = static_cast<int>(position);
+                const float fraction = position - static_cast<float>(index);
+                output[sample] = table[static_cast<size_t>(index)] + fraction * (table[static_cast<size_t>(index + 1)] - table[static_cast<size_t>(index)]);
+
+                lanePhase += increment;
+                lanePhase -= lanePhase >= 1.0 ? 1.0 : 0.0;
+            }
+        }
+
+        phase += increment * numSamples;
+        phase -= std::floor(phase);
+    }
+
+    // Control-rate version: the table is read (value and slope) only at the
+    // last sample of each interval (the last one may be shorter), and the
+    // samples in between follow a cubic Hermite segment. At LFO rates this
+    // stays within about 1e-6 of process(). The phase advances by numSamples.
+    void processControlRate(float* const* outputs, int numSamples, int interval) noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+        {
+            const double lanePhase = phase + offsets[static_cast<size_t>(lane)];
+            auto* output = outputs[lane];
+
+            // The first segment starts from the sample before the block
+            float startValue, startSlope;
+            evaluate(lanePhase - increment, startValue, startSlope);
+
+            for (int start = 0; start < numSamples; start += interval)
+            {
+                const int length = juce::jmin(interval, numSamples - start);
+
+                float endValue, endSlope;
+                evaluate(lanePhase + increment * (start + length - 1), endValue, endSlope);
+
+                // Cubic in the samples since the segment start
+                const float span = static_cast<float>(length);
+                const float secant = (endValue - startValue) / span;
+                const float c2 = (3.0f * secant - 2.0f * startSlope - endSlope) / span;
+                const float c3 = (startSlope + endSlope - 2.0f * secant) / (span * span);
+
+                for (int sample = 0; sample < length; ++sample)
+                {
+                    const float t = static_cast<float>(sample + 1);
+                    output[start + sample] = startValue + t * (startSlope + t * (c2 + t * c3));
+                }
+
+                startValue = endValue;
+                startSlope = endSlope;
+            }
+        }
+
+        phase += increment * numSamples;
+        phase -= std::floor(phase);
+    }
+
+private:
+    // One cycle plus guard points for the interpolation (the float position
+    // can round up to tableSize itself), built on first use
+    static const std::array<float, tableSize + 2>& getSineTable()
+    {
+        static const auto table = []
+        {
+            std::array<float, tableSize + 2> values{};
+            for (int i = 0; i < tableSize + 2; ++i)
+                values[static_cast<size_t>(i)] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * i / tableSize));
+            return values;
+        }();
+
+        return table;
+    }
+
+    // Table sine at atPhase (in cycles, any value) and its slope per sample
+    void evaluate(double atPhase, float& value, float& slope) const noexcept
+    {
+        value = lookup(atPhase);
+        slope = static_cast<float>(juce::MathConstants<double>::twoPi * increment) * lookup(atPhase + 0.25);
+    }
+
+    static float lookup(double atPhase) noexcept
+    {
+        const auto& table = getSineTable();
+        const float position = static_cast<float>((atPhase - std::floor(atPhase)) * tableSize);
+        const int index = static_cast<int>(position);
+        const float fraction = position - static_cast<float>(index);
+        return table[static_cast<size_t>(index)] + fraction * (table[static_cast<size_t>(index + 1)] - table[static_cast<size_t>(index)]);
+    }
+
+    void updateIncrement()
+    {
+        // Keep below one cycle per sample so a single wrap per step is enough
+        increment = juce::jlimit(0.0, 0.5, frequency / sr);
+    }
+
+    // Phase is kept in double: at 4x oversampling a 0.1 Hz increment is too
+    // small for a float accumulator near 1.0
+    double sr = 44100.0;
+    float frequency = 1.0f;
+    double increment = 0.0;
+    double phase = 0.0;
+    std::array<double, static_cast<size_t>(NumLanes)> offsets{};
+};
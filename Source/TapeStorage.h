@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    TapeStorage.h
+    Created: 16 Oct 2026
+
+    Sample formats the tape loop can be recorded in, and the conversions
+    between them and float. Long delays at high rates are mostly memory, so
+    the compact formats halve the footprint of the loop:
+
+        float32   4 bytes, exact
+        float16   2 bytes, 11-bit mantissa (about -66 dB relative error),
+                  normals down to 6e-5 and denormals down to 6e-8
+        int16     2 bytes, +-4.0 full scale (12 dB of headroom over 0 dBFS
+                  for the feedback build-up), TPDF dithered: a noise floor
+                  around -84 dBFS, in keeping with the lo-fi tape character,
+                  while the loop is carrying signal
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <cstring>
+
+enum class TapeStorageFormat
+{
+    float32,
+    float16,
+    int16
+};
+
+// Names used in the saved state and on the command line
+inline const char* getTapeStorageFormatName(TapeStorageFormat format)
+{
+    switch (format)
+    {
+        case TapeStorageFormat::float16: return "float16";
+        case TapeStorageFormat::int16:   return "int16";
+        case TapeStorageFormat::float32:
+        default:                         return "float32";
+    }
+}
+
+// Unknown names fall back to float32
+inline TapeStorageFormat getTapeStorageFormatFromName(const juce::String& name)
+{
+    if (name == "float16")
+        return TapeStorageFormat::float16;
+
+    if (name == "int16")
+        return TapeStorageFormat::int16;
+
+    return TapeStorageFormat::float32;
+}
+
+struct TapeStorageConversion
+{
+    //==============================================================================
+    // IEEE half precision, round to nearest even. Magnitudes are clamped to the
+    // largest finite half, so the tape never records an infinity or a NaN.
+    static inline juce::uint16 floatToHalf(float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(float));
+
+        const juce::uint32 sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7fffffffu;
+
+        float magnitude;
+        std::memcpy(&magnitude, &bits, sizeof(float));
+
+        // Below 2^-14 the result is a half denormal: adding a magic number
+        // lines the mantissa up with the half denormal bits
+        const float denormalMagic = 0.5f; // 2^-1 = 2^(-14 - 10 + 23)
+        const float shifted = magnitude + denormalMagic;
+        juce::uint32 shiftedBits;
+        std::memcpy(&shiftedBits, &shifted, sizeof(float));
+        const juce::uint32 denormal = shiftedBits - 0x3f000000u;
+
+        // Normals: rebias the exponent and round the 13 dropped bits to even
+        const juce::uint32 roundedBits = bits + 0xc8000fffu + ((bits >> 13) & 1u);
+        const juce::uint32 normal = roundedBits >> 13;
+
+        // Pick with masks rather than compares or min(): those let the compiler
+        // split the loop into branches. A mask is all ones when the difference
+        // is negative, i.e. below 2^-14 and above 65504 (0x477fe000).
+        const juce::uint32 denormalMask = static_cast<juce::uint32>(static_cast<int>(bits - 0x38800000u) >> 31);
+        const juce::uint32 overflowMask = static_cast<juce::uint32>(static_cast<int>(0x477fe000u - bits) >> 31);
+
+        juce::uint32 half = (denormal & denormalMask) | (normal & ~denormalMask);
+        half = (0x7bffu & overflowMask) | (half & ~overflowMask);
+        return static_cast<juce::uint16>(half | sign);
+    }
+
+    static inline float halfToFloat(juce::uint16 half) noexcept
+    {
+        const juce::uint32 bits = (static_cast<juce::uint32>(half) & 0x7fffu) << 13;
+
+        // Normals: rebias the exponent. Denormals (exponent 0): treat the
+        // mantissa as a normal with exponent -14 and take the implicit one away.
+        const juce::uint32 normalBits = bits + 0x38000000u;
+        const juce::uint32 denormalBits = bits + 0x38800000u;
+
+        float denormal;
+        std::memcpy(&denormal, &denormalBits, sizeof(float));
+        denormal -= 6.10351562e-5f; // 2^-14
+
+        juce::uint32 denormalResultBits;
+        std::memcpy(&denormalResultBits, &denormal, sizeof(float));
+
+        const juce::uint32 denormalMask = 0u - static_cast<juce::uint32>((bits & 0x0f800000u) == 0);
+        juce::uint32 resultBits = (denormalResultBits & denormalMask) | (normalBits & ~denormalMask);
+        resultBits |= (static_cast<juce::uint32>(half) & 0x8000u) << 16;
+
+        float result;
+        std::memcpy(&result, &resultBits, sizeof(float));
+        return result;
+    }
+
+    //==============================================================================
+    static constexpr float int16FullScale = 4.0f;
+
+    // TPDF dither in [-1, 1) LSB from a hash of a running counter, so every
+    // sample is independent of the previous one and the loop vectorises
+    static inline float ditherAt(juce::uint32 counter) noexcept
+    {
+        juce::uint32 hash = counter * 0x9e3779b1u;
+        hash ^= hash >> 15;
+        hash *= 0x85ebca77u;
+        hash ^= hash >> 13;
+
+        return static_cast<float>((hash & 0xffffu) + (hash >> 16)) * (1.0f / 65536.0f) - 1.0f;
+    }
+
+    // Values under half an LSB are recorded as an exact 0 without dither, so a
+    // silent loop stays silent instead of recirculating the dither (and the
+    // processor can go to sleep)
+    static inline juce::int16 floatToInt16(float value, juce::uint32 ditherCounter) noexcept
+    {
+        const float exact = value * (32767.0f / int16FullScale);
+        juce::uint32 exactBits;
+        std::memcpy(&exactBits, &exact, sizeof(float));
+
+        // Gate the dither with a mask rather than a compare, as in floatToHalf:
+        // the mask is all ones when |exact| is below 0.5 (0x3f000000)
+        const juce::uint32 silentMask = static_cast<juce::uint32>(static_cast<int>((exactBits & 0x7fffffffu) - 0x3f000000u) >> 31);
+
+        const float fullDither = ditherAt(ditherCounter);
+        juce::uint32 ditherBits;
+        std::memcpy(&ditherBits, &fullDither, sizeof(float));
+        ditherBits &= ~silentMask;
+
+        float dither;
+        std::memcpy(&dither, &ditherBits, sizeof(float));
+        const float scaled = exact + dither;
+
+        // Round to nearest by truncating a value offset to be positive, clamped
+        // to +-32767 after the offset (clamping first stops the vectoriser)
+        const float offset = std::min(std::max(scaled + 32768.5f, 1.0f), 65535.0f);
+        return static_cast<juce::int16>(static_cast<int>(offset) - 32768);
+    }
+
+    static inline float int16ToFloat(juce::int16 value) noexcept
+    {
+        return static_cast<float>(value) * (int16FullScale / 32767.0f);
+    }
+
+    //==============================================================================
+    // Block forms over flat arrays
+
+    static void toFloat(const juce::uint16* source, float* dest, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = halfToFloat(source[i]);
+    }
+
+    static void toFloat(const juce::int16* source, float* dest, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = int16ToFloat(source[i]);
+    }
+};
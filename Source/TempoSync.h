@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    TempoSync.h
+    Created: 16 Oct 2026
+
+    Note-division delay times from the host tempo. The tempo and time
+    signature are read from the play head once per block; the delay is only
+    recomputed when one of them or the division changes, so a steady tempo
+    gives a bit-identical delay time block after block and the processor can
+    tell a real change (which it crossfades to) from a repeat.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+
+// In SyncDivision parameter order
+enum class SyncDivision
+{
+    thirtySecond,
+    sixteenth,
+    eighth,
+    quarter,
+    half,
+    whole,
+    bar // one bar of the host time signature
+};
+
+// In SyncModifier parameter order
+enum class SyncModifier
+{
+    straight,
+    dotted,
+    triplet
+};
+
+class TempoSync
+{
+public:
+    // Length of a division in quarter notes
+    static double getQuarterNotes(SyncDivision division, SyncModifier modifier, int numerator, int denominator) noexcept
+    {
+        double quarterNotes = division == SyncDivision::bar
+            ? 4.0 * numerator / denominator
+            : 0.125 * static_cast<double>(1 << static_cast<int>(division));
+
+        if (modifier == SyncModifier::dotted)
+            quarterNotes *= 1.5;
+        else if (modifier == SyncModifier::triplet)
+            quarterNotes *= 2.0 / 3.0;
+
+        return quarterNotes;
+    }
+
+    // Delay time of the division at the host tempo, clamped to
+    // [minimumMs, maximumMs]. Hosts that report no tempo or time signature
+    // (or no play head) keep the last one seen, 120 bpm in 4/4 at first.
+    float getDelayMs(const juce::AudioPlayHead* playHead, SyncDivision division, SyncModifier modifier,
+        float minimumMs, float maximumMs)
+    {
+        if (playHead != nullptr)
+        {
+            if (const auto position = playHead->getPosition())
+            {
+                if (const auto bpm = position->getBpm(); bpm.hasValue() && *bpm > 0.0)
+                    tempo = *bpm;
+
+                if (const auto timeSignature = position->getTimeSignature();
+                    timeSignature.hasValue() && timeSignature->numerator > 0 && timeSignature->denominator > 0)
+                {
+                    numerator = timeSignature->numerator;
+                    denominator = timeSignature->denominator;
+                }
+            }
+        }
+
+        if (tempo != cachedTempo || numerator != cachedNumerator || denominator != cachedDenominator
+            || division != cachedDivision || modifier != cachedModifier)
+        {
+            cachedTempo = tempo;
+            cachedNumerator = numerator;
+            cachedDenominator = denominator;
+            cachedDivision = division;
+            cachedModifier = modifier;
+
+            const double delayMs = getQuarterNotes(division, modifier, numerator, denominator) * 60000.0 / tempo;
+            lastDelayMs = juce::jlimit(minimumMs, maximumMs, static_cast<float>(delayMs));
+        }
+
+        return lastDelayMs;
+    }
+
+    // Last delay handed out, for the message thread (tail length, prepare)
+    float getLastDelayMs() const noexcept { return lastDelayMs; }
+
+private:
+    double tempo = 120.0;
+    int numerator = 4;
+    int denominator = 4;
+
+    double cachedTempo = 0.0;
+    int cachedNumerator = 0;
+    int cachedDenominator = 0;
+    SyncDivision cachedDivision = SyncDivision::quarter;
+    SyncModifier cachedModifier = SyncModifier::straight;
+    std::atomic<float> lastDelayMs{ 500.0f };
+};
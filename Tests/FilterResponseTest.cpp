@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    FilterResponseTest.cpp (walrus-test-filter-response)
+    Created: 16 Oct 2026
+
+    Measures LaneStateVariableFilter with sines at full resonance, for both
+    FilterSlope settings. The low-pass and high-pass must reach +20 dB at the
+    cutoff and stay within maxPeakDb anywhere else, so the 24 dB/oct cascade
+    peaks no higher than a single stage; the band-pass must stay at unity at
+    its centre.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "TapeDSP.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr float cutoffHz = 1000.0f;
+    constexpr double cutoffGainDb = 20.0;
+    constexpr double maxPeakDb = 20.5;
+    constexpr double toleranceDb = 0.25;
+
+    // Steady-state gain of a sine at frequencyHz, from the second half of a
+    // half-second render
+    double measureGainDb(FilterMode mode, int numStages, float frequencyHz)
+    {
+        constexpr int numSamples = static_cast<int>(sampleRate / 2);
+
+        LaneStateVariableFilter<2> filter;
+        filter.prepare(sampleRate);
+
+        std::vector<TapeFrame<2>> frames(static_cast<size_t>(numSamples));
+        const std::vector<float> cutoff(static_cast<size_t>(numSamples), cutoffHz);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto value = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequencyHz * i / sampleRate));
+            frames[static_cast<size_t>(i)][0] = value;
+            frames[static_cast<size_t>(i)][1] = value;
+        }
+
+        filter.process(frames.data(), frames.data(), numSamples, cutoff.data(), 1.0f, mode, 1.0f, numStages);
+
+        float peak = 0.0f;
+        for (int i = numSamples / 2; i < numSamples; ++i)
+            peak = juce::jmax(peak, std::abs(frames[static_cast<size_t>(i)][0]));
+
+        return juce::Decibels::gainToDecibels(static_cast<double>(peak), -200.0);
+    }
+
+    // Highest gain over 250 Hz to 4 kHz, in sixteenth-octave steps
+    double measurePeakDb(FilterMode mode, int numStages)
+    {
+        double peakDb = -200.0;
+        for (int step = 0; step <= 64; ++step)
+            peakDb = juce::jmax(peakDb, measureGainDb(mode, numStages, 250.0f * std::pow(2.0f, static_cast<float>(step) / 16.0f)));
+
+        return peakDb;
+    }
+
+    bool check(const juce::String& name, double valueDb, double lowestDb, double highestDb)
+    {
+        const bool ok = valueDb >= lowestDb && valueDb <= highestDb;
+        std::cout << name << ": " << juce::String(valueDb, 2) << " dB (" << juce::String(lowestDb, 2) << " to "
+                  << juce::String(highestDb, 2) << ") " << (ok ? "ok" : "FAILED") << "\n";
+        return ok;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    bool passed = true;
+
+    for (int numStages : { 1, 2 })
+    {
+        const juce::String slope = juce::String(12 * numStages) + " dB/oct";
+
+        for (auto [mode, name] : { std::pair<FilterMode, const char*>{ FilterMode::lowPass, "low pass" }, { FilterMode::highPass, "high pass" } })
+        {
+            passed = check(slope + " " + name + " at cutoff", measureGainDb(mode, numStages, cutoffHz),
+                         cutoffGainDb - toleranceDb, cutoffGainDb + toleranceDb) && passed;
+            passed = check(slope + " " + name + " peak", measurePeakDb(mode, numStages), cutoffGainDb - toleranceDb, maxPeakDb) && passed;
+        }
+
+        passed = check(slope + " band pass at centre", measureGainDb(FilterMode::bandPass, numStages, cutoffHz),
+                     -toleranceDb, toleranceDb) && passed;
+    }
+
+    return passed ? 0 : 1;
+}
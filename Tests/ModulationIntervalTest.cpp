@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    ModulationIntervalTest.cpp (walrus-test-modulation-interval)
+    Created: 16 Oct 2026
+
+    The control-rate tape path reads the wow and flutter LFOs once per
+    modulation interval and follows a cubic in between. This renders the same
+    input with the per-sample reference path (interval 1) and with intervals
+    16 and 32, wow and flutter on, and fails if the peak difference reaches
+    maxDifferenceDb.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr double renderSeconds = 4.0;
+    constexpr double maxDifferenceDb = -60.0;
+
+    // Half a second of a two-tone burst, then the echoes
+    juce::AudioBuffer<float> makeInput()
+    {
+        juce::AudioBuffer<float> input(2, static_cast<int>(sampleRate * renderSeconds));
+        input.clear();
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto* data = input.getWritePointer(channel);
+            for (int i = 0; i < static_cast<int>(sampleRate * 0.5); ++i)
+            {
+                const double t = i / sampleRate;
+                data[i] = static_cast<float>(0.4 * std::sin(juce::MathConstants<double>::twoPi * 440.0 * t)
+                    + 0.2 * std::sin(juce::MathConstants<double>::twoPi * (1250.0 + 100.0 * channel) * t));
+            }
+        }
+
+        return input;
+    }
+
+    juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, int modulationInterval)
+    {
+        WalrusDelay1AudioProcessor processor;
+        processor.setModulationInterval(modulationInterval);
+
+        for (const auto& [id, value] : { std::pair<const char*, float>{ "WowDepth", 0.6f }, { "FlutterDepth", 0.4f }, { "Feedback", 0.6f } })
+        {
+            auto* parameter = processor.apvts.getParameter(id);
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> output;
+        output.makeCopyOf(input);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start,
+                juce::jmin(blockSize, output.getNumSamples() - start));
+            processor.processBlock(block, midi);
+        }
+
+        return output;
+    }
+
+    double getPeakDifferenceDb(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference)
+    {
+        double peakDifference = 0.0;
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < output.getNumSamples(); ++i)
+                peakDifference = juce::jmax(peakDifference,
+                    std::abs(static_cast<double>(output.getSample(channel, i)) - reference.getSample(channel, i)));
+
+        return juce::Decibels::gainToDecibels(peakDifference, -200.0);
+    }
+}
+
+//==============================================================================
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto input = makeInput();
+    const auto reference = render(input, 1);
+    bool passed = true;
+
+    for (int interval : { 16, 32 })
+    {
+        const double differenceDb = getPeakDifferenceDb(render(input, interval), reference);
+        const bool ok = differenceDb < maxDifferenceDb;
+        passed = passed && ok;
+
+        std::cout << "interval " << interval << ": peak difference " << juce::String(differenceDb, 1)
+                  << " dBFS (limit " << juce::String(maxDifferenceDb, 1) << ") " << (ok ? "ok" : "FAILED") << "\n";
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    TapeSleepTest.cpp (walrus-test-tape-sleep)
+    Created: 16 Oct 2026
+
+    Plays a short burst into the tape loop in every storage format, then
+    silence, and fails unless the processor has gone to sleep within
+    maxSleepSeconds. The int16 format dithers what it records, so this checks
+    that a silent loop does not keep recirculating the dither.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr double burstSeconds = 0.3;
+    constexpr double maxSleepSeconds = 30.0;
+
+    // Seconds of processing until the processor sleeps, or a negative value
+    // if it is still awake after maxSleepSeconds
+    double getSecondsUntilSleep(TapeStorageFormat format)
+    {
+        WalrusDelay1AudioProcessor processor;
+        processor.setTapeStorageFormat(format);
+
+        auto* feedback = processor.apvts.getParameter("Feedback");
+        feedback->setValueNotifyingHost(feedback->convertTo0to1(0.6f));
+
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> block(2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < static_cast<int>(sampleRate * maxSleepSeconds); start += blockSize)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    block.setSample(channel, i, start + i < sampleRate * burstSeconds
+                        ? static_cast<float>(0.5 * std::sin(juce::MathConstants<double>::twoPi * 440.0 * (start + i) / sampleRate))
+                        : 0.0f);
+
+            processor.processBlock(block, midi);
+
+            if (processor.isSleeping())
+                return (start + blockSize) / sampleRate;
+        }
+
+        return -1.0;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    bool passed = true;
+
+    for (auto format : { TapeStorageFormat::float32, TapeStorageFormat::float16, TapeStorageFormat::int16 })
+    {
+        const double seconds = getSecondsUntilSleep(format);
+        const bool ok = seconds >= 0.0;
+        passed = passed && ok;
+
+        std::cout << getTapeStorageFormatName(format) << ": "
+                  << (ok ? "asleep after " + juce::String(seconds, 1) + " s ok" : juce::String("still awake FAILED")) << "\n";
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,452 @@
+/*
+  ==============================================================================
+
+    Main.cpp (walrus-render)
+    Created: 16 Oct 2026
+
+    Streams a WAV file through WalrusDelay1AudioProcessor outside of a host
+    and reports how fast it ran compared to real time.
+
+    walrus-render <input.wav> [--out=<output.wav>] [--block=512] [--rate=48000]
+                  [--passes=1] [--non-realtime] [--saturation=fast|exact] [--modulation-interval=8]
+                  [--tape-storage=float32|float16|int16] [--tempo=120[:180]] [--time-signature=4/4]
+                  [--compare=<reference.wav>] [--param=DelayTime=350] [--param=...]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+namespace
+{
+    struct RenderOptions
+    {
+        juce::File inputFile;
+        juce::File outputFile;
+        int blockSize = 512;
+        double sampleRate = 0.0; // 0 = use the input file's rate
+        int passes = 1;
+        bool nonRealtime = false;
+        juce::String saturation; // empty = whatever the render profile picks
+        int modulationInterval = 8;
+        TapeStorageFormat tapeStorage = TapeStorageFormat::float32;
+        double startTempo = 0.0; // 0 = no play head, like a host without a transport
+        double endTempo = 0.0;
+        juce::AudioPlayHead::TimeSignature timeSignature;
+        juce::File compareFile;
+        juce::StringPairArray parameters;
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: walrus-render <input.wav> [options]\n"
+                     "  --out=<file.wav>     write the processed audio (24-bit WAV)\n"
+                     "  --block=<samples>    processBlock size (default 512)\n"
+                     "  --rate=<hz>          processing sample rate (default: input file rate)\n"
+                     "  --passes=<n>         render the file n times and average the timing\n"
+                     "  --non-realtime       render like a host bounce, with the offline render profile\n"
+                     "  --saturation=<mode>  fast or exact saturation kernels (default: from the profile)\n"
+                     "  --modulation-interval=<samples>\n"
+                     "                       wow/flutter control interval, 1 = per sample (default 8)\n"
+                     "  --tape-storage=<format>\n"
+                     "                       float32 (default), float16 or int16 (dithered) tape loop\n"
+                     "  --tempo=<bpm>[:<bpm>]  host tempo for DelaySync, ramped linearly over the file\n"
+                     "                       when a second value is given\n"
+                     "  --time-signature=<n>/<d>  host time signature (default 4/4)\n"
+                     "  --compare=<file.wav>  report the difference between the output and a reference\n"
+                     "                       render, e.g. one made with --modulation-interval=1\n"
+                     "  --param=<id>=<value> set a parameter in plain units, e.g. --param=Feedback=0.7\n";
+    }
+
+    bool parseArguments(const juce::StringArray& args, RenderOptions& options, juce::String& error)
+    {
+        for (auto& arg : args)
+        {
+            if (!arg.startsWith("--"))
+            {
+                if (options.inputFile != juce::File())
+                {
+                    error = "more than one input file given: " + arg;
+                    return false;
+                }
+
+                options.inputFile = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+                continue;
+            }
+
+            auto key = arg.substring(2).upToFirstOccurrenceOf("=", false, false);
+            auto value = arg.fromFirstOccurrenceOf("=", false, false);
+
+            if (key == "out")
+                options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+            else if (key == "block")
+                options.blockSize = value.getIntValue();
+            else if (key == "rate")
+                options.sampleRate = value.getDoubleValue();
+            else if (key == "passes")
+                options.passes = value.getIntValue();
+            else if (key == "non-realtime" && value.isEmpty())
+                options.nonRealtime = true;
+            else if (key == "saturation" && (value == "fast" || value == "exact"))
+                options.saturation = value;
+            else if (key == "modulation-interval")
+                options.modulationInterval = value.getIntValue();
+            else if (key == "tape-storage" && (value == "float32" || value == "float16" || value == "int16"))
+                options.tapeStorage = getTapeStorageFormatFromName(value);
+            else if (key == "tempo")
+            {
+                options.startTempo = value.upToFirstOccurrenceOf(":", false, false).getDoubleValue();
+                options.endTempo = value.containsChar(':') ? value.fromFirstOccurrenceOf(":", false, false).getDoubleValue()
+                                                           : options.startTempo;
+            }
+            else if (key == "time-signature")
+            {
+                options.timeSignature.numerator = value.upToFirstOccurrenceOf("/", false, false).getIntValue();
+                options.timeSignature.denominator = value.fromFirstOccurrenceOf("/", false, false).getIntValue();
+            }
+            else if (key == "compare")
+                options.compareFile = juce::File::getCurrentWorkingDirectory().getChildFile(value);
+            else if (key == "param")
+                options.parameters.set(value.upToFirstOccurrenceOf("=", false, false),
+                                       value.fromFirstOccurrenceOf("=", false, false));
+            else
+            {
+                error = "unknown option: " + arg;
+                return false;
+            }
+        }
+
+        if (options.inputFile == juce::File() || !options.inputFile.existsAsFile())
+            error = "input file not found";
+        else if (options.blockSize < 1)
+            error = "--block must be at least 1";
+        else if (options.sampleRate < 0.0)
+            error = "--rate must be positive";
+        else if (options.passes < 1)
+            error = "--passes must be at least 1";
+        else if (options.modulationInterval < 1)
+            error = "--modulation-interval must be at least 1";
+        else if (options.startTempo < 0.0 || options.endTempo < 0.0)
+            error = "--tempo must be positive";
+        else if (options.timeSignature.numerator < 1 || options.timeSignature.denominator < 1)
+            error = "--time-signature must look like 3/4";
+        else if (options.compareFile != juce::File() && !options.compareFile.existsAsFile())
+            error = "reference file not found";
+
+        return error.isEmpty();
+    }
+
+    // Input, output and reference audio go through in chunks of about this
+    // many samples (a whole number of blocks), so files of any length render
+    // in constant memory
+    constexpr int streamChunkSamples = 1 << 16;
+
+    // The input file as stereo at the processing rate (mono files are
+    // duplicated to both channels), read a chunk at a time
+    class StreamedInput
+    {
+    public:
+        bool open(const juce::File& file, double targetRate, int maximumChunkSamples)
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+            if (reader == nullptr)
+                return false;
+
+            fileSampleRate = reader->sampleRate;
+            fileLength = reader->lengthInSamples;
+            sampleRate = targetRate > 0.0 ? targetRate : fileSampleRate;
+            readerSource = std::make_unique<juce::AudioFormatReaderSource>(reader.release(), true);
+
+            if (sampleRate != fileSampleRate)
+            {
+                resampler = std::make_unique<juce::ResamplingAudioSource>(readerSource.get(), false, 2);
+                resampler->setResamplingRatio(fileSampleRate / sampleRate);
+                resampler->prepareToPlay(maximumChunkSamples, sampleRate);
+            }
+
+            return true;
+        }
+
+        double getSampleRate() const { return sampleRate; }
+        juce::int64 getLengthInSamples() const
+        {
+            return static_cast<juce::int64>(std::ceil(static_cast<double>(fileLength) * sampleRate / fileSampleRate));
+        }
+
+        void rewind()
+        {
+            readerSource->setNextReadPosition(0);
+            if (resampler != nullptr)
+                resampler->flushBuffers();
+        }
+
+        void read(juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            const juce::AudioSourceChannelInfo info(&buffer, 0, numSamples);
+            if (resampler != nullptr)
+                resampler->getNextAudioBlock(info);
+            else
+                readerSource->getNextAudioBlock(info);
+        }
+
+    private:
+        std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+        std::unique_ptr<juce::ResamplingAudioSource> resampler;
+        double fileSampleRate = 0.0;
+        double sampleRate = 0.0;
+        juce::int64 fileLength = 0;
+    };
+
+    // Stands in for the host transport: a tempo that is moved along every block
+    struct RenderPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override { return position; }
+
+        PositionInfo position;
+    };
+
+    bool applyParameters(WalrusDelay1AudioProcessor& processor, const juce::StringPairArray& parameters)
+    {
+        for (auto& id : parameters.getAllKeys())
+        {
+            auto* parameter = processor.apvts.getParameter(id);
+            if (parameter == nullptr)
+            {
+                std::cerr << "unknown parameter: " << id << "\n";
+                return false;
+            }
+
+            const float value = parameters[id].getFloatValue();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        }
+
+        return true;
+    }
+
+    // Peak and overall level of (output - reference), relative to full scale
+    // and to the reference, over the length both files share
+    struct DifferenceMeter
+    {
+        void add(const juce::AudioBuffer<float>& output, const juce::AudioBuffer<float>& reference, int numSamples)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                const auto* out = output.getReadPointer(channel);
+                const auto* ref = reference.getReadPointer(channel);
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const double difference = static_cast<double>(out[i]) - ref[i];
+                    peakDifference = juce::jmax(peakDifference, std::abs(difference));
+                    differenceEnergy += difference * difference;
+                    referenceEnergy += static_cast<double>(ref[i]) * ref[i];
+                }
+            }
+        }
+
+        void print(juce::int64 outputLength, juce::int64 referenceLength) const
+        {
+            if (outputLength != referenceLength)
+                std::cout << "compare:          lengths differ, compared the first "
+                          << juce::jmin(outputLength, referenceLength) << " samples\n";
+
+            std::cout << "peak difference:  " << juce::String(juce::Decibels::gainToDecibels(peakDifference, -200.0), 1) << " dBFS\n"
+                      << "difference/ref:   " << juce::String(juce::Decibels::gainToDecibels(
+                             std::sqrt(differenceEnergy / juce::jmax(referenceEnergy, 1.0e-30)), -200.0), 1) << " dB\n";
+        }
+
+        double peakDifference = 0.0, differenceEnergy = 0.0, referenceEnergy = 0.0;
+    };
+
+    // Stereo 24-bit WAV; the file is complete once the writer is deleted
+    std::unique_ptr<juce::AudioFormatWriter> createOutputWriter(const juce::File& file, double sampleRate)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+        if (stream == nullptr)
+            return {};
+
+        juce::WavAudioFormat wavFormat;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+        if (writer != nullptr)
+            stream.release(); // now owned by the writer
+
+        return writer;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderOptions options;
+    juce::String error;
+    if (!parseArguments(juce::StringArray(argv + 1, argc - 1), options, error))
+    {
+        std::cerr << "walrus-render: " << error << "\n\n";
+        printUsage();
+        return 1;
+    }
+
+    // Every chunk is a whole number of blocks, so the block sizes are the
+    // same as with the file processed in one piece
+    const int chunkSamples = options.blockSize * juce::jmax(1, streamChunkSamples / options.blockSize);
+
+    StreamedInput input;
+    if (!input.open(options.inputFile, options.sampleRate, chunkSamples))
+    {
+        std::cerr << "walrus-render: could not read " << options.inputFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    const double sampleRate = input.getSampleRate();
+    const juce::int64 numSamples = input.getLengthInSamples();
+
+    // The reference is read alongside the last pass and must be at the same rate
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reference;
+    if (options.compareFile != juce::File())
+    {
+        reference = std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(options.compareFile));
+        if (reference == nullptr || reference->sampleRate != sampleRate)
+        {
+            std::cerr << "walrus-render: " << options.compareFile.getFullPathName()
+                      << " is not a WAV file at " << juce::String(sampleRate, 0) << " Hz\n";
+            return 1;
+        }
+    }
+
+    // The last pass is written out
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if (options.outputFile != juce::File())
+    {
+        writer = createOutputWriter(options.outputFile, sampleRate);
+        if (writer == nullptr)
+        {
+            std::cerr << "walrus-render: could not write " << options.outputFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    WalrusDelay1AudioProcessor processor;
+    processor.setNonRealtime(options.nonRealtime);
+
+    const auto renderMode = processor.getRenderMode();
+    auto profile = processor.getRenderProfile(renderMode);
+    if (options.saturation.isNotEmpty())
+        profile.saturationAccuracy = options.saturation == "exact" ? SaturationAccuracy::exact : SaturationAccuracy::fast;
+    processor.setRenderProfile(renderMode, profile);
+
+    RenderPlayHead playHead;
+    playHead.position.setTimeSignature(options.timeSignature);
+    if (options.startTempo > 0.0)
+        processor.setPlayHead(&playHead);
+
+    processor.setModulationInterval(options.modulationInterval);
+    processor.setTapeStorageFormat(options.tapeStorage);
+    if (!applyParameters(processor, options.parameters))
+        return 1;
+
+    juce::AudioBuffer<float> chunk(2, chunkSamples);
+    juce::AudioBuffer<float> referenceChunk(2, chunkSamples);
+    DifferenceMeter difference;
+    juce::MidiBuffer midi;
+    double totalSeconds = 0.0;
+    double worstBlockSeconds = 0.0;
+    int numBlocks = 0;
+
+    for (int pass = 0; pass < options.passes; ++pass)
+    {
+        // Every pass starts from a freshly prepared (silent) processor
+        processor.setPlayConfigDetails(2, 2, sampleRate, options.blockSize);
+        processor.prepareToPlay(sampleRate, options.blockSize);
+        input.rewind();
+        const bool lastPass = pass == options.passes - 1;
+
+        for (juce::int64 chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSamples)
+        {
+            const int chunkLength = static_cast<int>(juce::jmin(static_cast<juce::int64>(chunkSamples), numSamples - chunkStart));
+            input.read(chunk, chunkLength);
+
+            for (int start = 0; start < chunkLength; start += options.blockSize)
+            {
+                const int blockSamples = juce::jmin(options.blockSize, chunkLength - start);
+                juce::AudioBuffer<float> block(chunk.getArrayOfWritePointers(), 2, start, blockSamples);
+                playHead.position.setBpm(options.startTempo + (options.endTempo - options.startTempo)
+                    * static_cast<double>(chunkStart + start) / static_cast<double>(numSamples));
+
+                const auto startTicks = juce::Time::getHighResolutionTicks();
+                processor.processBlock(block, midi);
+                const auto blockSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+                totalSeconds += blockSeconds;
+                worstBlockSeconds = juce::jmax(worstBlockSeconds, blockSeconds);
+                ++numBlocks;
+            }
+
+            if (!lastPass)
+                continue;
+
+            if (writer != nullptr && !writer->writeFromAudioSampleBuffer(chunk, 0, chunkLength))
+            {
+                std::cerr << "walrus-render: could not write " << options.outputFile.getFullPathName() << "\n";
+                return 1;
+            }
+
+            const int referenceLength = reference != nullptr
+                ? static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(chunkLength), reference->lengthInSamples - chunkStart))
+                : 0;
+            if (referenceLength > 0)
+            {
+                reference->read(&referenceChunk, 0, referenceLength, chunkStart, true, true);
+                difference.add(chunk, referenceChunk, referenceLength);
+            }
+        }
+
+        processor.releaseResources();
+    }
+
+    // Closing the writer finishes the file
+    writer.reset();
+
+    const double audioSeconds = static_cast<double>(numSamples) / sampleRate * options.passes;
+    const double blockBudgetSeconds = options.blockSize / sampleRate;
+
+    std::cout << "input:            " << options.inputFile.getFileName() << " ("
+              << juce::String(static_cast<double>(numSamples) / sampleRate, 2) << " s)\n"
+              << "sample rate:      " << juce::String(sampleRate, 0) << " Hz\n"
+              << "block size:       " << options.blockSize << "\n"
+              << "passes:           " << options.passes << "\n"
+              << "render mode:      " << (renderMode == WalrusDelay1AudioProcessor::RenderMode::offline ? "offline" : "realtime") << "\n"
+              << "saturation:       " << (profile.saturationAccuracy == SaturationAccuracy::fast ? "fast" : "exact") << "\n"
+              << "mod. interval:    " << options.modulationInterval << "\n"
+              << "tempo:            " << (options.startTempo > 0.0
+                     ? juce::String(options.startTempo, 1) + (options.endTempo != options.startTempo ? " -> " + juce::String(options.endTempo, 1) : juce::String())
+                         + " bpm in " + juce::String(options.timeSignature.numerator) + "/" + juce::String(options.timeSignature.denominator)
+                     : juce::String("none (no play head)")) << "\n"
+              << "tape storage:     " << getTapeStorageFormatName(options.tapeStorage) << " ("
+              << juce::String(static_cast<double>(processor.getTapeStorageSizeInBytes()) / (1024.0 * 1024.0), 2) << " MB)\n"
+              << "processing time:  " << juce::String(totalSeconds, 4) << " s\n"
+              << "real-time factor: " << juce::String(audioSeconds / juce::jmax(totalSeconds, 1.0e-9), 1) << "x\n"
+              << "mean block:       " << juce::String(totalSeconds / juce::jmax(numBlocks, 1) * 1.0e6, 2) << " us"
+              << " (budget " << juce::String(blockBudgetSeconds * 1.0e6, 2) << " us)\n"
+              << "worst block:      " << juce::String(worstBlockSeconds * 1.0e6, 2) << " us\n";
+
+    if (AllocationTripwire::getViolationCount() > 0)
+        std::cout << "WARNING:          " << AllocationTripwire::getViolationCount()
+                  << " heap allocation(s) inside processBlock\n";
+
+    if (reference != nullptr)
+        difference.print(numSamples, reference->lengthInSamples);
+
+    if (options.outputFile != juce::File())
+        std::cout << "wrote:            " << options.outputFile.getFullPathName() << "\n";
+
+    return 0;
+}